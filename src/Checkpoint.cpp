@@ -0,0 +1,159 @@
+/**
+ * @file Checkpoint.cpp
+ * @brief Implementação dos checkpoints das fases do Sample Sort.
+ */
+
+#include "Checkpoint.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace dnasort {
+
+#define CHECKPOINT_VERSION 1
+
+namespace {
+
+/**
+ * @brief Cabeçalho fixo de um arquivo de checkpoint (seguido da etiqueta e das contagens).
+ */
+struct CheckpointHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t phase;
+    uint32_t rank;
+    uint32_t size;
+    uint64_t tag_len;
+};
+
+/**
+ * @brief Contagens gravadas após a etiqueta.
+ */
+struct CheckpointCounts {
+    uint64_t count;
+    uint64_t pivot_count;
+    uint64_t payload;
+};
+
+/**
+ * @brief Lê o cabeçalho, a etiqueta e as contagens de um checkpoint.
+ * @return false se o arquivo não existe ou está truncado.
+ */
+bool read_header(ifstream& file, CheckpointHeader& header, string& tag, CheckpointCounts& counts) {
+    if (!file.read((char*)&header, sizeof(header)) || memcmp(header.magic, "DSCK", 4) != 0) return false;
+    if (header.tag_len > (1 << 20)) return false;
+    tag.resize(header.tag_len);
+    return file.read(&tag[0], tag.size()) && file.read((char*)&counts, sizeof(counts));
+}
+
+void write_strings(ofstream& file, const vector<string>& data) {
+    for (const auto& s : data) {
+        uint32_t len = s.size();
+        file.write((const char*)&len, sizeof(len));
+        file.write(s.data(), len);
+    }
+}
+
+void read_strings(ifstream& file, uint64_t count, vector<string>& data) {
+    data.resize(count);
+    for (auto& s : data) {
+        uint32_t len;
+        file.read((char*)&len, sizeof(len));
+        s.resize(len);
+        if (len > 0) file.read(&s[0], len);
+    }
+}
+
+} // namespace
+
+SortCheckpoint::SortCheckpoint(Comm& comm, const string& dir, const string& tag)
+    : dir_(dir), tag_(tag), rank_(comm.rank()), size_(comm.size()), resumed_(CheckpointPhase::NONE),
+      failed_(false), seconds_(0) {
+    if (mkdir(dir_.c_str(), 0755) != 0 && errno != EEXIST) failed_ = true;
+}
+
+string SortCheckpoint::filename(CheckpointPhase phase) const {
+    char name[64];
+    snprintf(name, sizeof(name), "/sort-r%05d-of%05d.%s", rank_, size_,
+             phase == CheckpointPhase::LOCAL_SORT ? "local" : "exchange");
+    return dir_ + name;
+}
+
+bool SortCheckpoint::valid(CheckpointPhase phase) const {
+    ifstream file(filename(phase), ios::binary);
+    CheckpointHeader header;
+    CheckpointCounts counts;
+    string tag;
+    if (!read_header(file, header, tag, counts)) return false;
+    if (header.version != CHECKPOINT_VERSION || header.phase != (uint32_t)phase || header.rank != (uint32_t)rank_ ||
+        header.size != (uint32_t)size_ || tag != tag_) return false;
+
+    // O arquivo está completo se os bytes restantes conferem com o cabeçalho
+    streamoff pos = file.tellg();
+    file.seekg(0, ios::end);
+    return file && (uint64_t)(file.tellg() - pos) == counts.payload;
+}
+
+CheckpointPhase SortCheckpoint::find_resume_phase(Comm& comm) {
+    uint64_t mine[2] = {valid(CheckpointPhase::LOCAL_SORT), valid(CheckpointPhase::EXCHANGE)};
+    uint64_t all[2];
+    allreduce(comm, mine, all, 2, ReduceOp::MIN);
+    resumed_ = all[1] ? CheckpointPhase::EXCHANGE : all[0] ? CheckpointPhase::LOCAL_SORT : CheckpointPhase::NONE;
+    return resumed_;
+}
+
+void SortCheckpoint::save(CheckpointPhase phase, const vector<string>& data, const vector<string>& pivots) {
+    auto start = chrono::steady_clock::now();
+    string name = filename(phase), tmp = name + ".tmp";
+
+    CheckpointHeader header = {{'D', 'S', 'C', 'K'}, CHECKPOINT_VERSION, (uint32_t)phase,
+                               (uint32_t)rank_, (uint32_t)size_, tag_.size()};
+    CheckpointCounts counts = {data.size(), pivots.size(), 0};
+    for (const auto& s : pivots) counts.payload += sizeof(uint32_t) + s.size();
+    for (const auto& s : data) counts.payload += sizeof(uint32_t) + s.size();
+
+    ofstream file(tmp, ios::binary);
+    file.write((const char*)&header, sizeof(header));
+    file.write(tag_.data(), tag_.size());
+    file.write((const char*)&counts, sizeof(counts));
+    write_strings(file, pivots);
+    write_strings(file, data);
+    file.close();
+    if (!file || rename(tmp.c_str(), name.c_str()) != 0) {
+        unlink(tmp.c_str());
+        failed_ = true;
+    }
+    seconds_ += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+vector<string> SortCheckpoint::load(CheckpointPhase phase, vector<string>* pivots) const {
+    string name = filename(phase);
+    ifstream file(name, ios::binary);
+    CheckpointHeader header;
+    CheckpointCounts counts;
+    string tag;
+    if (!read_header(file, header, tag, counts)) {throw runtime_error("Checkpoint inválido: " + name);}
+
+    vector<string> saved_pivots, data;
+    read_strings(file, counts.pivot_count, saved_pivots);
+    read_strings(file, counts.count, data);
+    if (!file) {throw runtime_error("Checkpoint inválido: " + name);}
+    if (pivots) pivots->swap(saved_pivots);
+    return data;
+}
+
+void SortCheckpoint::remove() const {
+    unlink(filename(CheckpointPhase::LOCAL_SORT).c_str());
+    unlink(filename(CheckpointPhase::EXCHANGE).c_str());
+}
+
+} // namespace dnasort
@@ -0,0 +1,95 @@
+/**
+ * @file Checkpoint.h
+ * @brief Checkpoints das fases do Sample Sort, para retomar execuções longas após uma falha.
+ *
+ * Cada rank grava, em um diretório (local ao nó ou compartilhado), a sua run ordenada após a
+ * ordenação local e a sua partição final e os pivôs após a troca. Na retomada, a fase mais
+ * avançada salva por todos os ranks é recarregada e as fases anteriores (inclusive a leitura
+ * da entrada) são puladas.
+ *
+ * Formato de cada arquivo "<dir>/sort-rNNNNN-ofNNNNN.<fase>" (binário, ordem de bytes nativa):
+ *   "DSCK", versão, fase, rank e número de ranks (uint32 cada), tamanho da etiqueta (uint64) e a
+ *   etiqueta, número de sequências, número de pivôs e bytes restantes (uint64 cada), e então
+ *   os pivôs e as sequências, cada um como tamanho (uint32) seguido dos bytes.
+ * A etiqueta identifica a entrada e as opções; checkpoints de outra entrada são ignorados.
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Comm.h"
+
+namespace dnasort {
+
+/**
+ * @brief Fases do Sample Sort que podem ser salvas, da menos para a mais avançada.
+ */
+enum class CheckpointPhase {
+    NONE = 0,        ///< Nada salvo: começa pela leitura da entrada.
+    LOCAL_SORT = 1,  ///< Run ordenada de cada rank, antes da amostragem.
+    EXCHANGE = 2     ///< Partição final ordenada de cada rank e os pivôs.
+};
+
+/**
+ * @brief Checkpoints de um rank em um diretório.
+ */
+class SortCheckpoint {
+public:
+    /**
+     * @param comm Comunicador da ordenação (define o rank e o número de ranks dos arquivos).
+     * @param dir Diretório dos checkpoints (criado se não existe).
+     * @param tag Identificação da entrada e das opções (igual em todos os ranks).
+     */
+    SortCheckpoint(Comm& comm, const std::string& dir, const std::string& tag);
+
+    /**
+     * @brief Coletiva: procura a fase mais avançada salva, com a mesma etiqueta, por todos os ranks.
+     * @return Fase a retomar (também devolvida por resumed()).
+     */
+    CheckpointPhase find_resume_phase(Comm& comm);
+
+    /** @brief Fase encontrada por find_resume_phase (NONE se não foi chamada). */
+    CheckpointPhase resumed() const { return resumed_; }
+
+    /**
+     * @brief Grava os dados de uma fase (arquivo temporário e rename). Falhas são registradas em failed().
+     */
+    void save(CheckpointPhase phase, const std::vector<std::string>& data,
+              const std::vector<std::string>& pivots = std::vector<std::string>());
+
+    /**
+     * @brief Lê os dados de uma fase salva; lança runtime_error se o arquivo é inválido.
+     * @param phase Fase.
+     * @param pivots Se não nulo, recebe os pivôs salvos.
+     */
+    std::vector<std::string> load(CheckpointPhase phase, std::vector<std::string>* pivots = 0) const;
+
+    /** @brief Remove os arquivos deste rank (após a conclusão da execução). */
+    void remove() const;
+
+    /** @brief true se alguma gravação falhou. */
+    bool failed() const { return failed_; }
+
+    /** @brief Tempo total gasto em save, em segundos. */
+    double seconds() const { return seconds_; }
+
+private:
+    std::string filename(CheckpointPhase phase) const;
+    bool valid(CheckpointPhase phase) const;
+
+    std::string dir_;
+    std::string tag_;
+    int rank_;
+    int size_;
+    CheckpointPhase resumed_;
+    bool failed_;
+    double seconds_;
+};
+
+} // namespace dnasort
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,173 @@
+/**
+ * @file Collation.h
+ * @brief Ordens de ordenação (colações) como políticas com codificadores de chave.
+ *
+ * Cada política converte uma sequência em uma chave cuja ordem lexicográfica de bytes (a de
+ * std::string) é a ordem desejada, e de volta. Assim, a ordenação local, a troca por pivôs, os
+ * checkpoints e a gravação por faixas continuam comparando strings com memcmp, sem um
+ * comparador genérico, como já é feito com a forma canônica (to_canonical_key). As chaves
+ * de sequências com caracteres imprimíveis (0x20 a 0x7E) não contêm '\n', de modo que pivôs e
+ * manifestos gravados em texto continuam válidos.
+ *
+ * Uso com uma política fixa em tempo de compilação:
+ *   dnasort::sort_by(data, dnasort::LengthFirstOrder());
+ *   dnasort::sort_by(data, dnasort::BaseOrder("ACTG"));
+ *
+ * As opções de tempo de execução (SortOptions::collation) usam as mesmas políticas em
+ * encode_keys e decode_keys (DnaSort.h).
+ */
+
+#ifndef COLLATION_H
+#define COLLATION_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "DnaSort.h"
+
+namespace dnasort {
+
+/**
+ * @brief Ordem lexicográfica dos bytes: a chave é a própria sequência.
+ */
+struct LexicographicOrder {
+    void encode(std::string&) const {}
+    void decode(std::string&) const {}
+};
+
+/**
+ * @brief Tamanho crescente e, entre sequências de mesmo tamanho, ordem lexicográfica.
+ *
+ * A chave começa com o tamanho em LENGTH_DIGITS dígitos de base 64 ('0' a 'o'), do mais
+ * significativo para o menos.
+ */
+struct LengthFirstOrder {
+    static const int LENGTH_DIGITS = 6;  ///< Tamanhos até 64^6 - 1.
+
+    void encode(std::string& seq) const {
+        char prefix[LENGTH_DIGITS];
+        std::size_t len = seq.size();
+        for (int i = LENGTH_DIGITS - 1; i >= 0; i--, len >>= 6) prefix[i] = (char)('0' + (len & 63));
+        seq.insert(0, prefix, LENGTH_DIGITS);
+    }
+    void decode(std::string& key) const {
+        key.erase(0, LENGTH_DIGITS);
+    }
+};
+
+/**
+ * @brief Ordem lexicográfica inversa (maior primeiro).
+ *
+ * Cada caractere imprimível c vira 0x9E - c, que também é imprimível e inverte a ordem, e a
+ * chave termina com 0x7F, maior que qualquer caractere convertido, de modo que uma sequência
+ * venha depois das que a estendem.
+ */
+struct ReverseOrder {
+    void encode(std::string& seq) const {
+        for (auto& c : seq) c = (char)(0x9E - (unsigned char)c);
+        seq.push_back('\x7F');
+    }
+    void decode(std::string& key) const {
+        key.pop_back();
+        for (auto& c : key) c = (char)(0x9E - (unsigned char)c);
+    }
+};
+
+/**
+ * @brief Ordem das bases dada por uma permutação de "ACGT" (por exemplo "ACTG": A < C < T < G).
+ *
+ * As bases são trocadas entre si para que a permutação fique em ordem alfabética; os demais
+ * caracteres mantêm o seu valor.
+ */
+class BaseOrder {
+public:
+    /**
+     * @param bases Permutação de "ACGT"; lança invalid_argument caso contrário.
+     */
+    explicit BaseOrder(const std::string& bases) {
+        if (!is_valid(bases)) throw std::invalid_argument("Ordem de bases inválida: " + bases);
+        for (int c = 0; c < 256; c++) to_key_[c] = from_key_[c] = (char)c;
+        for (int i = 0; i < 4; i++) {
+            to_key_[(unsigned char)bases[i]] = "ACGT"[i];
+            from_key_[(unsigned char)"ACGT"[i]] = bases[i];
+        }
+    }
+
+    /** @brief Indica se bases é uma permutação de "ACGT". */
+    static bool is_valid(const std::string& bases) {
+        if (bases.size() != 4) return false;
+        for (char b : std::string("ACGT")) if (bases.find(b) == std::string::npos) return false;
+        return true;
+    }
+
+    void encode(std::string& seq) const {
+        for (auto& c : seq) c = to_key_[(unsigned char)c];
+    }
+    void decode(std::string& key) const {
+        for (auto& c : key) c = from_key_[(unsigned char)c];
+    }
+
+private:
+    char to_key_[256];
+    char from_key_[256];
+};
+
+/**
+ * @brief Converte as sequências de [first, last) nas chaves da política order.
+ */
+template <typename Order>
+void encode_keys(std::string* first, std::string* last, const Order& order) {
+    for (std::string* it = first; it != last; ++it) order.encode(*it);
+}
+
+/**
+ * @brief Recupera as sequências de [first, last) a partir das chaves da política order.
+ */
+template <typename Order>
+void decode_keys(std::string* first, std::string* last, const Order& order) {
+    for (std::string* it = first; it != last; ++it) order.decode(*it);
+}
+
+/**
+ * @brief Ordena data na ordem da política order.
+ */
+template <typename Order>
+void sort_by(std::vector<std::string>& data, const Order& order = Order()) {
+    encode_keys(data.data(), data.data() + data.size(), order);
+    sequential_sort(data);
+    decode_keys(data.data(), data.data() + data.size(), order);
+}
+
+/**
+ * @brief Interpreta o nome de uma ordem ("lex", "length", "reverse" ou uma permutação de "ACGT").
+ * @param name Nome da ordem.
+ * @param opts Recebe a ordem em collation e base_order.
+ * @return false se o nome é inválido.
+ */
+inline bool parse_collation(const std::string& name, SortOptions& opts) {
+    if (name == "lex") opts.collation = Collation::LEXICOGRAPHIC;
+    else if (name == "length") opts.collation = Collation::LENGTH_FIRST;
+    else if (name == "reverse") opts.collation = Collation::REVERSE;
+    else if (BaseOrder::is_valid(name)) opts.collation = Collation::BASES;
+    else return false;
+    opts.base_order = (opts.collation == Collation::BASES) ? name : "";
+    return true;
+}
+
+/**
+ * @brief Nome da ordem de opts, no formato aceito por parse_collation.
+ */
+inline std::string collation_name(const SortOptions& opts) {
+    switch (opts.collation) {
+    case Collation::LENGTH_FIRST: return "length";
+    case Collation::REVERSE: return "reverse";
+    case Collation::BASES: return opts.base_order;
+    default: return "lex";
+    }
+}
+
+} // namespace dnasort
+
+#endif // COLLATION_H
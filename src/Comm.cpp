@@ -0,0 +1,38 @@
+/**
+ * @file Comm.cpp
+ * @brief Funções comuns às implementações de Comm.
+ */
+
+#include "Comm.h"
+
+#include <cstring>
+
+using namespace std;
+
+namespace dnasort {
+
+vector<char> pack_strings(const vector<string>& data) {
+    size_t bytes = 0;
+    for (const auto& seq : data) bytes += seq.size() + 1;
+
+    vector<char> buf(bytes);
+    char* out = buf.data();
+    for (const auto& seq : data) {
+        memcpy(out, seq.c_str(), seq.size() + 1);
+        out += seq.size() + 1;
+    }
+    return buf;
+}
+
+vector<string> unpack_strings(const char* buf, size_t bytes) {
+    vector<string> data;
+    size_t pos = 0;
+    while (pos < bytes) {
+        size_t len = strlen(buf + pos);
+        data.emplace_back(buf + pos, len);
+        pos += len + 1;
+    }
+    return data;
+}
+
+} // namespace dnasort
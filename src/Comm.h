@@ -0,0 +1,231 @@
+/**
+ * @file Comm.h
+ * @brief Interface de comunicação usada pelos algoritmos distribuídos da biblioteca.
+ *
+ * Os algoritmos (Sample Sort, seleção, k-mers, vetor de sufixos) usam apenas as operações
+ * desta interface. Há duas implementações:
+ * - MpiComm (MpiComm.h): processos MPI, cada rank é um processo.
+ * - ThreadComm (ThreadComm.h): threads em um único processo, que trocam ponteiros em vez de
+ *   mensagens; permite executar o Sample Sort sem MPI e sem cópias das sequências.
+ */
+
+#ifndef COMM_H
+#define COMM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#define MASTER 0
+
+namespace dnasort {
+
+/**
+ * @brief Tipos de elemento aceitos pelas reduções.
+ */
+enum class DataType { INT64, UINT64, DOUBLE };
+
+/**
+ * @brief Operações de redução.
+ */
+enum class ReduceOp { SUM, MAX, MIN };
+
+/**
+ * @brief Comunicador abstrato entre os ranks que executam um algoritmo distribuído.
+ *
+ * As operações coletivas devem ser chamadas por todos os ranks na mesma ordem, como no MPI.
+ * Os tamanhos são em bytes; os deslocamentos das operações "v" são as somas de prefixo dos
+ * tamanhos (os dados de cada rank ficam contíguos, em ordem de rank).
+ */
+class Comm {
+public:
+    virtual ~Comm() {}
+
+    virtual int rank() const = 0;
+    virtual int size() const = 0;
+
+    /** @brief Relógio de parede em segundos. */
+    virtual double wtime() const = 0;
+
+    virtual void barrier() = 0;
+
+    /**
+     * @brief Divide os ranks em sub-comunicadores (como MPI_Comm_split).
+     * @param color Ranks com a mesma cor ficam no mesmo sub-comunicador.
+     * @param key Ordem dos ranks no sub-comunicador (empates pela ordem atual).
+     * @return Sub-comunicador do rank atual.
+     */
+    virtual std::unique_ptr<Comm> split(int color, int key) = 0;
+
+    /** @brief Envio bloqueante de bytes (o buffer pode ser reutilizado no retorno). */
+    virtual void send(const void* buf, std::size_t bytes, int dest, int tag) = 0;
+
+    /** @brief Recebimento bloqueante de exatamente bytes bytes. */
+    virtual void recv(void* buf, std::size_t bytes, int source, int tag) = 0;
+
+    virtual void bcast(void* buf, std::size_t bytes, int root) = 0;
+
+    /** @brief Cada rank contribui com bytes bytes; root recebe size * bytes em ordem de rank. */
+    virtual void gather(const void* send, std::size_t bytes, void* recv, int root) = 0;
+
+    /** @brief Como gather, com recv_bytes[p] bytes de cada rank p (relevante apenas em root). */
+    virtual void gatherv(const void* send, std::size_t bytes, void* recv, const std::size_t* recv_bytes, int root) = 0;
+
+    virtual void allgather(const void* send, std::size_t bytes, void* recv) = 0;
+
+    /** @brief Cada rank envia bytes bytes a cada rank (bloco p de send vai para o rank p). */
+    virtual void alltoall(const void* send, std::size_t bytes, void* recv) = 0;
+
+    virtual void alltoallv(const void* send, const std::size_t* send_bytes,
+                           void* recv, const std::size_t* recv_bytes) = 0;
+
+    virtual void allreduce(const void* in, void* out, int count, DataType type, ReduceOp op) = 0;
+
+    /** @brief Redução exclusiva por prefixo de rank; o rank 0 recebe zeros. */
+    virtual void exscan(const void* in, void* out, int count, DataType type, ReduceOp op) = 0;
+
+    /**
+     * @brief Envia um vetor de sequências. O conteúdo pode ser movido (data fica vazio).
+     *
+     * Usa as tags tag e tag + 1.
+     */
+    virtual void send_strings(std::vector<std::string>& data, int dest, int tag) = 0;
+
+    /** @brief Recebe um vetor de sequências enviado por send_strings. */
+    virtual std::vector<std::string> recv_strings(int source, int tag) = 0;
+
+    /**
+     * @brief Reúne em root as sequências de todos os ranks, em ordem de rank.
+     * @param local Sequências do rank atual; pode ser movido (fica vazio).
+     * @return Em root, a concatenação; vazio nos demais.
+     */
+    virtual std::vector<std::string> gather_strings(std::vector<std::string>& local, int root) = 0;
+
+    /** @brief Difunde um vetor de sequências de root para todos os ranks. */
+    virtual void bcast_strings(std::vector<std::string>& data, int root) = 0;
+
+    /**
+     * @brief Troca de sequências agrupadas por destino.
+     * @param send Sequências em ordem de destino; pode ser movido (fica vazio).
+     * @param send_counts Quantidade de sequências destinada a cada rank.
+     * @return Sequências recebidas, em ordem de rank de origem.
+     */
+    virtual std::vector<std::string> alltoallv_strings(std::vector<std::string>& send,
+                                                       const std::vector<std::size_t>& send_counts) = 0;
+};
+
+/**
+ * @brief Concatena sequências em um único buffer, separadas por '\0'.
+ * @param data Vetor de strings a ser empacotado.
+ * @return Buffer contíguo pronto para envio em uma única mensagem.
+ */
+std::vector<char> pack_strings(const std::vector<std::string>& data);
+
+/**
+ * @brief Operação inversa de pack_strings.
+ * @param buf Buffer com sequências separadas por '\0'.
+ * @param bytes Quantidade de bytes válidos em buf.
+ * @return Vetor de strings.
+ */
+std::vector<std::string> unpack_strings(const char* buf, std::size_t bytes);
+
+/**
+ * @brief DataType correspondente a um tipo aritmético de 64 bits.
+ */
+template <typename T>
+DataType data_type() {
+    static_assert(sizeof(T) == 8 && std::is_arithmetic<T>::value, "reduções suportam apenas tipos de 64 bits");
+    return std::is_floating_point<T>::value ? DataType::DOUBLE
+         : std::is_signed<T>::value ? DataType::INT64 : DataType::UINT64;
+}
+
+/**
+ * @brief Redução de count valores do tipo T entre todos os ranks.
+ */
+template <typename T>
+void allreduce(Comm& comm, const T* in, T* out, int count, ReduceOp op) {
+    comm.allreduce(in, out, count, data_type<T>(), op);
+}
+
+/**
+ * @brief Redução de um único valor entre todos os ranks.
+ */
+template <typename T>
+T allreduce(Comm& comm, T value, ReduceOp op) {
+    T result;
+    comm.allreduce(&value, &result, 1, data_type<T>(), op);
+    return result;
+}
+
+/**
+ * @brief Redução exclusiva por prefixo de um único valor (0 no rank 0).
+ */
+template <typename T>
+T exscan(Comm& comm, T value, ReduceOp op) {
+    T result;
+    comm.exscan(&value, &result, 1, data_type<T>(), op);
+    return result;
+}
+
+/**
+ * @brief Reúne em MASTER vetores de tipo trivial de todos os ranks, em ordem de rank.
+ * @param comm Comunicador.
+ * @param local Elementos do rank atual.
+ * @return Em MASTER, a concatenação dos elementos de todos os ranks; vazio nos demais.
+ */
+template <typename T>
+std::vector<T> gather_pod(Comm& comm, const std::vector<T>& local) {
+    std::size_t bytes = local.size() * sizeof(T);
+    std::vector<std::size_t> counts(comm.size());
+    comm.gather(&bytes, sizeof(bytes), counts.data(), MASTER);
+
+    std::vector<T> gathered;
+    if (comm.rank() == MASTER) {
+        std::size_t total = 0;
+        for (std::size_t c : counts) total += c;
+        gathered.resize(total / sizeof(T));
+    }
+    comm.gatherv(local.data(), bytes, gathered.data(), counts.data(), MASTER);
+    return gathered;
+}
+
+/**
+ * @brief Difunde um vetor de tipo trivial de MASTER para todos os ranks.
+ * @param comm Comunicador.
+ * @param data Elementos a difundir (entrada em MASTER, saída nos demais).
+ */
+template <typename T>
+void bcast_pod(Comm& comm, std::vector<T>& data) {
+    std::size_t n = data.size();
+    comm.bcast(&n, sizeof(n), MASTER);
+    data.resize(n);
+    comm.bcast(data.data(), n * sizeof(T), MASTER);
+}
+
+/**
+ * @brief Troca de dados entre ranks para vetores de tipo trivial agrupados por destino.
+ * @param comm Comunicador.
+ * @param send Elementos a enviar, agrupados em ordem de rank destino.
+ * @param send_counts Quantidade de elementos destinada a cada rank.
+ * @return Elementos recebidos, em ordem de rank de origem.
+ */
+template <typename T>
+std::vector<T> alltoallv_pod(Comm& comm, const std::vector<T>& send, const std::vector<std::size_t>& send_counts) {
+    int size = comm.size();
+    std::vector<std::size_t> send_bytes(size), recv_bytes(size);
+    for (int p = 0; p < size; p++) send_bytes[p] = send_counts[p] * sizeof(T);
+    comm.alltoall(send_bytes.data(), sizeof(std::size_t), recv_bytes.data());
+
+    std::size_t total = 0;
+    for (int p = 0; p < size; p++) total += recv_bytes[p];
+    std::vector<T> received(total / sizeof(T));
+    comm.alltoallv(send.data(), send_bytes.data(), received.data(), recv_bytes.data());
+    return received;
+}
+
+} // namespace dnasort
+
+#endif // COMM_H
@@ -0,0 +1,446 @@
+/**
+ * @file DnaSort.cpp
+ * @brief Implementação da parte local (sem MPI) da biblioteca de ordenação de sequências de DNA.
+ */
+
+#include "DnaSort.h"
+#include "Collation.h"
+
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <tmmintrin.h>
+#define HAVE_SSSE3_DISPATCH 1
+#endif
+
+// Marcadores de orientação anexados às chaves canônicas; ambos são menores que qualquer base,
+// de modo que a comparação lexicográfica das chaves equivale à comparação das formas canônicas.
+#define FORWARD_MARK '+'
+#define REVERSE_MARK '-'
+
+#define LONG_READ_BYTES 256   ///< Tamanho médio a partir do qual sequential_sort usa sort_long_reads.
+#define SMALL_WORD_GROUP 16   ///< Grupos de sort_long_reads até este tamanho são ordenados por comparação.
+
+using namespace std;
+
+namespace dnasort {
+
+/**
+ * @brief Palavra de 8 bytes de uma sequência a partir de depth, com o primeiro byte no topo
+ *        (completada com zeros após o fim), de modo que a ordem das palavras é a dos bytes.
+ */
+static inline uint64_t load_word(const string& seq, size_t depth) {
+    if (depth >= seq.size()) return 0;
+    size_t n = min<size_t>(8, seq.size() - depth);
+    const unsigned char* p = (const unsigned char*)seq.data() + depth;
+    uint64_t word = 0;
+    for (size_t i = 0; i < n; i++) word |= (uint64_t)p[i] << (56 - 8 * i);
+    return word;
+}
+
+/**
+ * @brief Tamanho do prefixo comum de a e b a partir de depth, comparando blocos de tamanho
+ *        dobrado a cada passo com memcmp até a primeira diferença.
+ */
+static size_t common_prefix(const string& a, const string& b, size_t depth) {
+    size_t limit = min(a.size(), b.size());
+    size_t pos = depth, step = 8;
+    while (pos < limit) {
+        size_t n = min(step, limit - pos);
+        if (memcmp(a.data() + pos, b.data() + pos, n) != 0) {
+            while (a[pos] == b[pos]) pos++;
+            break;
+        }
+        pos += n;
+        step *= 2;
+    }
+    return min(pos, limit) - depth;
+}
+
+/**
+ * @brief Palavra de depth em diante e posição de uma sequência longa.
+ */
+struct WordRef {
+    uint64_t word;
+    size_t index;
+};
+
+void sort_long_reads(vector<string>& data) {
+    vector<WordRef> refs(data.size());
+    for (size_t i = 0; i < data.size(); i++) refs[i].index = i;
+
+    // Grupos pendentes; cada grupo só contém sequências iguais até depth
+    struct Group { size_t first, last, depth; bool compare; };
+    vector<Group> pending(1, Group{0, refs.size(), 0, false});
+    while (!pending.empty()) {
+        Group g = pending.back();
+        pending.pop_back();
+        WordRef* first = refs.data() + g.first;
+        WordRef* last = refs.data() + g.last;
+        if (g.compare || last - first <= SMALL_WORD_GROUP) {
+            std::sort(first, last, [&](const WordRef& a, const WordRef& b) {
+                return data[a.index].compare(g.depth, string::npos, data[b.index], g.depth, string::npos) < 0;
+            });
+            continue;
+        }
+        for (WordRef* r = first; r != last; ++r) r->word = load_word(data[r->index], g.depth);
+        std::sort(first, last, [](const WordRef& a, const WordRef& b) { return a.word < b.word; });
+
+        // Palavras iguais: se as sequências continuam, o grupo segue após o prefixo comum a todas
+        for (WordRef* run = first; run != last; ) {
+            WordRef* end = run + 1;
+            while (end != last && end->word == run->word) ++end;
+            bool longer = false;
+            for (WordRef* r = run; end - run > 1 && r != end && !longer; ++r) longer = data[r->index].size() > g.depth + 8;
+            if (longer) {
+                const string& head = data[run->index];
+                size_t common = string::npos;
+                for (WordRef* r = run + 1; r != end && common > 0; ++r) {
+                    common = min(common, common_prefix(head, data[r->index], g.depth + 8));
+                }
+                // Um grupo que quase não diminuiu (prefixos longos e desiguais) segue por comparação
+                bool compare = (size_t)(end - run) > (g.last - g.first) / 2;
+                pending.push_back(Group{(size_t)(run - refs.data()), (size_t)(end - refs.data()), g.depth + 8 + common, compare});
+            }
+            run = end;
+        }
+    }
+
+    vector<string> sorted(data.size());
+    for (size_t i = 0; i < refs.size(); i++) sorted[i].swap(data[refs[i].index]);
+    data.swap(sorted);
+}
+
+/**
+ * @brief Indica se o tamanho médio das sequências de [first, last) justifica sort_long_reads.
+ */
+static bool long_reads(const string* first, const string* last) {
+    size_t bytes = 0;
+    for (const string* it = first; it != last; ++it) bytes += it->size();
+    return first != last && bytes / (last - first) >= LONG_READ_BYTES;
+}
+
+void sequential_sort(vector<string>& data) {
+    if (long_reads(data.data(), data.data() + data.size())) sort_long_reads(data);
+    else std::sort(data.begin(), data.end());
+}
+
+void sort(string* first, string* last, const SortOptions& opts) {
+    to_sort_keys(first, last, opts);
+    if (opts.key_field > 0 || opts.key_prefix > 0 || long_reads(first, last)) {
+        vector<string> records(make_move_iterator(first), make_move_iterator(last));
+        sort_keys(records, opts);
+        move(records.begin(), records.end(), first);
+    } else {
+        std::sort(first, last);
+    }
+    from_sort_keys(first, last, opts);
+}
+
+/**
+ * @brief Chave de um registro: intervalo do campo dentro do registro e posição do registro.
+ */
+struct RecordView {
+    const char* key;
+    size_t len;
+    size_t index;
+};
+
+void sort_records(vector<string>& data, const SortOptions& opts) {
+    vector<RecordView> views(data.size());
+    for (size_t i = 0; i < data.size(); i++) {
+        views[i].key = record_key(data[i], opts.key_field, opts.delimiter, &views[i].len);
+        views[i].index = i;
+    }
+    std::sort(views.begin(), views.end(), [&](const RecordView& a, const RecordView& b) {
+        int c = memcmp(a.key, b.key, a.len < b.len ? a.len : b.len);
+        if (c != 0) return c < 0;
+        if (a.len != b.len) return a.len < b.len;
+        return data[a.index] < data[b.index];
+    });
+
+    vector<string> sorted(data.size());
+    for (size_t i = 0; i < views.size(); i++) sorted[i].swap(data[views[i].index]);
+    data.swap(sorted);
+}
+
+/**
+ * @brief Código de 3 bits de cada caractere nas chaves de prefixo (0 é o fim da sequência).
+ */
+struct PrefixCodes {
+    unsigned char code[256];
+
+    PrefixCodes() {
+        for (int c = 0; c < 256; c++) code[c] = 4;
+        code[(unsigned char)'A'] = 1;
+        code[(unsigned char)'C'] = 2;
+        code[(unsigned char)'G'] = 3;
+        code[(unsigned char)'T'] = 5;
+    }
+};
+
+uint64_t prefix_key(const char* seq, size_t len, int k) {
+    static const PrefixCodes codes;
+    uint64_t key = 0;
+    for (int i = 0; i < k; i++) {
+        key = (key << 3) | ((size_t)i < len ? codes.code[(unsigned char)seq[i]] : 0);
+    }
+    return key;
+}
+
+/**
+ * @brief Chave de prefixo e posição de uma sequência.
+ */
+struct PrefixRef {
+    uint64_t key;
+    size_t index;
+};
+
+vector<uint64_t> sort_by_prefix(vector<string>& keys, const SortOptions& opts) {
+    vector<PrefixRef> refs(keys.size()), buffer(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) refs[i] = PrefixRef{prefix_key(keys[i], opts), i};
+
+    // Radix sort LSD com dígitos de 8 bits; dígitos iguais em todas as chaves não movem nada
+    for (int shift = 0; shift < 3 * opts.key_prefix; shift += 8) {
+        size_t count[257] = {0};
+        for (const auto& ref : refs) count[((ref.key >> shift) & 0xFF) + 1]++;
+        if (*max_element(count + 1, count + 257) == refs.size()) continue;
+        for (int d = 0; d < 256; d++) count[d + 1] += count[d];
+        for (const auto& ref : refs) buffer[count[(ref.key >> shift) & 0xFF]++] = ref;
+        refs.swap(buffer);
+    }
+
+    vector<string> sorted(keys.size());
+    vector<uint64_t> prefixes(keys.size());
+    for (size_t i = 0; i < refs.size(); i++) {
+        sorted[i].swap(keys[refs[i].index]);
+        prefixes[i] = refs[i].key;
+    }
+    keys.swap(sorted);
+    return prefixes;
+}
+
+void sort_keys(vector<string>& keys, const SortOptions& opts) {
+    if (opts.key_prefix > 0) sort_by_prefix(keys, opts);
+    else if (opts.key_field > 0) sort_records(keys, opts);
+    else sequential_sort(keys);
+}
+
+void sort(vector<string>& data, const SortOptions& opts) {
+    sort(data.data(), data.data() + data.size(), opts);
+}
+
+/**
+ * @brief Aplica a política de opts.collation a [first, last).
+ */
+static void encode_collation(string* first, string* last, const SortOptions& opts) {
+    switch (opts.collation) {
+    case Collation::LENGTH_FIRST: encode_keys(first, last, LengthFirstOrder()); break;
+    case Collation::REVERSE: encode_keys(first, last, ReverseOrder()); break;
+    case Collation::BASES: encode_keys(first, last, BaseOrder(opts.base_order)); break;
+    default: break;
+    }
+}
+
+/**
+ * @brief Desfaz a política de opts.collation em [first, last).
+ */
+static void decode_collation(string* first, string* last, const SortOptions& opts) {
+    switch (opts.collation) {
+    case Collation::LENGTH_FIRST: decode_keys(first, last, LengthFirstOrder()); break;
+    case Collation::REVERSE: decode_keys(first, last, ReverseOrder()); break;
+    case Collation::BASES: decode_keys(first, last, BaseOrder(opts.base_order)); break;
+    default: break;
+    }
+}
+
+void to_sort_keys(string* first, string* last, const SortOptions& opts) {
+    if (opts.canonical) for (string* it = first; it != last; ++it) to_canonical_key(*it);
+    encode_collation(first, last, opts);
+}
+
+void to_sort_keys(vector<string>& data, const SortOptions& opts) {
+    to_sort_keys(data.data(), data.data() + data.size(), opts);
+}
+
+void from_sort_keys(string* first, string* last, const SortOptions& opts) {
+    decode_collation(first, last, opts);
+    if (opts.canonical) for (string* it = first; it != last; ++it) from_canonical_key(*it);
+}
+
+void from_sort_keys(vector<string>& data, const SortOptions& opts) {
+    from_sort_keys(data.data(), data.data() + data.size(), opts);
+}
+
+void decode_pivots(vector<string>& pivots, const SortOptions& opts) {
+    decode_collation(pivots.data(), pivots.data() + pivots.size(), opts);
+    // A forma canônica, sem o marcador de orientação
+    if (opts.canonical) {
+        for (auto& pivot : pivots) {
+            if (!pivot.empty()) pivot.pop_back();
+        }
+    }
+}
+
+void encode_pivots(vector<string>& pivots, const SortOptions& opts) {
+    if (opts.canonical) for (auto& pivot : pivots) pivot += FORWARD_MARK;
+    encode_collation(pivots.data(), pivots.data() + pivots.size(), opts);
+}
+
+vector<string> read_file(const string& filename) {
+    ifstream file(filename);
+    if (!file.is_open()) {throw runtime_error("Erro ao abrir o arquivo de entrada: " + filename);}
+
+    vector<string> data;
+    string line;
+    while (getline(file, line)) {
+        if (!line.empty()) { data.push_back(line); }
+    }
+    file.close();
+    return data;
+}
+
+void write_file(const string& filename, const vector<string>& data, size_t index_block) {
+    ofstream file(filename);
+    if (!file.is_open()) {throw runtime_error("Erro ao abrir o arquivo de saída: " + filename);}
+
+    for (const auto& seq : data) {
+        file << seq << "\n";
+    }
+    file.close();
+
+    if (index_block > 0) write_index(filename, data, index_block);
+}
+
+void write_index(const string& filename, const vector<string>& data, size_t block) {
+    vector<IndexEntry> entries;
+    string keys;
+    uint64_t offset = 0;
+    for (size_t i = 0; i < data.size(); i++) {
+        if (i % block == 0) {
+            entries.push_back(IndexEntry{offset, i, keys.size(), data[i].size()});
+            keys += data[i];
+        }
+        offset += data[i].size() + 1;
+    }
+    write_index_entries(filename, block, entries, keys, data.size(), offset);
+}
+
+void write_index_entries(const string& filename, size_t block, const vector<IndexEntry>& entries,
+                         const string& keys, uint64_t lines, uint64_t bytes) {
+    string index_filename = filename + ".idx";
+    ofstream file(index_filename, ios::binary);
+    if (!file.is_open()) {throw runtime_error("Erro ao abrir o arquivo de saída: " + index_filename);}
+
+    uint64_t header[4] = {block, entries.size(), lines, bytes};
+    file.write("SIDX", 4);
+    file.write((const char*)header, sizeof(header));
+    file.write((const char*)entries.data(), entries.size() * sizeof(IndexEntry));
+    file.write(keys.data(), keys.size());
+    file.close();
+}
+
+/**
+ * @brief Complemento de uma base (A<->T, C<->G); outros caracteres são mantidos.
+ * @param c Base.
+ * @return Base complementar.
+ */
+static inline char complement(char c) {
+    switch (c) {
+        case 'A': return 'T';
+        case 'C': return 'G';
+        case 'G': return 'C';
+        case 'T': return 'A';
+        default:  return c;
+    }
+}
+
+#ifdef HAVE_SSSE3_DISPATCH
+/**
+ * @brief Reverso complementar vetorizado com SSSE3, 16 bases por iteração.
+ *
+ * Cada bloco é invertido com um shuffle de bytes e complementado por uma tabela indexada pelo
+ * nibble inferior do código ASCII ('A'=1, 'C'=3, 'G'=7, 'T'=4, 'N'=14), aplicada com um
+ * segundo shuffle. Como outros bytes (minúsculas, 'X', ...) compartilham esses nibbles, uma
+ * segunda tabela devolve a base esperada para cada nibble; onde o byte original difere dela,
+ * ele é mantido, como em complement().
+ *
+ * @param in Sequência de entrada.
+ * @param len Tamanho da sequência.
+ * @param out Buffer de saída com pelo menos len bytes.
+ * @return Quantidade de bases processadas (múltiplo de 16); o restante fica para o laço escalar.
+ */
+__attribute__((target("ssse3")))
+static size_t reverse_complement_ssse3(const char* in, size_t len, char* out) {
+    const __m128i reverse = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    const __m128i table = _mm_setr_epi8(0, 'T', 0, 'G', 'A', 0, 0, 'C', 0, 0, 0, 0, 0, 0, 'N', 0);
+    const __m128i bases = _mm_setr_epi8(0, 'A', 0, 'C', 'T', 0, 0, 'G', 0, 0, 0, 0, 0, 0, 'N', 0);
+    const __m128i low_nibble = _mm_set1_epi8(0x0F);
+
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(in + len - i - 16));
+        v = _mm_shuffle_epi8(v, reverse);
+        __m128i index = _mm_and_si128(v, low_nibble);
+        __m128i known = _mm_cmpeq_epi8(_mm_shuffle_epi8(bases, index), v);
+        __m128i comp = _mm_shuffle_epi8(table, index);
+        v = _mm_or_si128(_mm_and_si128(known, comp), _mm_andnot_si128(known, v));
+        _mm_storeu_si128((__m128i*)(out + i), v);
+    }
+    return i;
+}
+
+/**
+ * @brief Confere, uma vez, se reverse_complement_ssse3 coincide com o laço escalar.
+ *
+ * A entrada mistura ACGTN com minúsculas, bytes que compartilham os nibbles das bases e bytes
+ * acima de 0x7F. Se houver divergência, reverse_complement usa apenas o laço escalar.
+ */
+static bool ssse3_matches_scalar() {
+    const string sample = string("ACGTNacgtnXQDWS.\x81\xC1\xC7\xD4-+ TTTTXTTTTTTTTTTTTTTTTTTT") +
+                          "ggggccccaaaattttggggACGTTGCAN";
+    string simd(sample.size(), '\0'), scalar(sample.size(), '\0');
+    size_t done = reverse_complement_ssse3(sample.data(), sample.size(), &simd[0]);
+    for (size_t i = 0; i < sample.size(); i++) {
+        scalar[i] = complement(sample[sample.size() - 1 - i]);
+        if (i >= done) simd[i] = scalar[i];
+    }
+    return done > 0 && simd == scalar;
+}
+#endif
+
+void reverse_complement(const char* in, size_t len, char* out) {
+    size_t i = 0;
+#ifdef HAVE_SSSE3_DISPATCH
+    static const bool use_ssse3 = __builtin_cpu_supports("ssse3") && ssse3_matches_scalar();
+    if (use_ssse3) i = reverse_complement_ssse3(in, len, out);
+#endif
+    for (; i < len; i++) out[i] = complement(in[len - 1 - i]);
+}
+
+void to_canonical_key(string& seq) {
+    size_t len = seq.size();
+    string rc(len + 1, REVERSE_MARK);
+    reverse_complement(seq.data(), len, &rc[0]);
+    if (seq.compare(0, len, rc, 0, len) <= 0) {
+        seq.push_back(FORWARD_MARK);
+    } else {
+        seq.swap(rc);
+    }
+}
+
+void from_canonical_key(string& key) {
+    if (key.empty()) return;
+    char mark = key.back();
+    key.pop_back();
+    if (mark == REVERSE_MARK) {
+        string original(key.size(), '\0');
+        reverse_complement(key.data(), key.size(), &original[0]);
+        key.swap(original);
+    }
+}
+
+} // namespace dnasort
@@ -0,0 +1,302 @@
+/**
+ * @file DnaSort.h
+ * @brief Biblioteca de ordenação de sequências de DNA: leitura, escrita e ordenação local em memória.
+ *
+ * Reúne o código comum aos programas SequentialSort e SampleSort. Não depende de MPI; a parte
+ * distribuída da biblioteca está em ParallelSort.h.
+ *
+ * Exemplo de uso:
+ *   std::vector<std::string> data = dnasort::read_file("in.txt");
+ *   dnasort::SortOptions opts;
+ *   opts.canonical = true;
+ *   dnasort::sort(data, opts);
+ */
+
+#ifndef DNASORT_H
+#define DNASORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace dnasort {
+
+/**
+ * @brief Ordem das sequências (as políticas correspondentes estão em Collation.h).
+ */
+enum class Collation {
+    LEXICOGRAPHIC,  ///< Ordem lexicográfica dos bytes.
+    LENGTH_FIRST,   ///< Tamanho e, no mesmo tamanho, ordem lexicográfica.
+    REVERSE,        ///< Ordem lexicográfica inversa.
+    BASES           ///< Ordem lexicográfica com a ordem de bases de SortOptions::base_order.
+};
+
+/**
+ * @brief Opções que definem a ordem produzida pelas funções de ordenação.
+ */
+struct SortOptions {
+    bool canonical = false;  ///< Ordena pela forma canônica (sequência ou reverso complementar).
+    Collation collation = Collation::LEXICOGRAPHIC; ///< Ordem das sequências (ou das formas canônicas).
+    std::string base_order;  ///< Com Collation::BASES, permutação de "ACGT" (ex. "ACTG": A < C < T < G).
+    int key_field = 0;       ///< Quando > 0, ordena registros delimitados pelo campo key_field (base 1).
+    char delimiter = '\t';   ///< Separador dos campos dos registros.
+    int key_prefix = 0;      ///< Quando > 0, ordena apenas pelas primeiras key_prefix bases (ver sort_by_prefix).
+};
+
+/** @brief Maior valor de SortOptions::key_prefix: 3 bits por base em uma chave de 64 bits. */
+const int MAX_KEY_PREFIX = 21;
+
+/**
+ * @brief Campo field (base 1) de um registro delimitado, como intervalo dentro do próprio registro.
+ * @param record Registro (uma linha, sem o '\n').
+ * @param field Número do campo.
+ * @param delimiter Separador dos campos.
+ * @param len Recebe o tamanho do campo (0 se o registro tem menos campos).
+ * @return Início do campo em record.
+ */
+inline const char* record_key(const std::string& record, int field, char delimiter, std::size_t* len) {
+    const char* begin = record.data();
+    const char* end = begin + record.size();
+    for (int f = 1; f < field && begin != end; f++) {
+        const char* sep = (const char*)std::memchr(begin, delimiter, end - begin);
+        begin = sep ? sep + 1 : end;
+    }
+    const char* sep = (const char*)std::memchr(begin, delimiter, end - begin);
+    *len = (sep ? sep : end) - begin;
+    return begin;
+}
+
+/**
+ * @brief Interpreta o separador de campos da linha de comando: um caractere, "tab" ou "\\t".
+ * @return false se o separador é inválido.
+ */
+inline bool parse_delimiter(const std::string& arg, char& delimiter) {
+    if (arg == "tab" || arg == "\\t") delimiter = '\t';
+    else if (arg.size() == 1 && arg[0] != '\n') delimiter = arg[0];
+    else return false;
+    return true;
+}
+
+/**
+ * @brief Ordem dos registros pelo campo-chave (bytes, como std::string) e, com chaves iguais,
+ *        pelo registro inteiro, de modo que a saída não depende da ordem de entrada.
+ */
+struct RecordLess {
+    int field;
+    char delimiter;
+
+    RecordLess(const SortOptions& opts) : field(opts.key_field), delimiter(opts.delimiter) {}
+
+    bool operator()(const std::string& a, const std::string& b) const {
+        std::size_t alen, blen;
+        const char* akey = record_key(a, field, delimiter, &alen);
+        const char* bkey = record_key(b, field, delimiter, &blen);
+        int c = std::memcmp(akey, bkey, alen < blen ? alen : blen);
+        if (c != 0) return c < 0;
+        if (alen != blen) return alen < blen;
+        return a < b;
+    }
+};
+
+/**
+ * @brief Ordena registros pelo campo opts.key_field (RecordLess).
+ *
+ * O início e o tamanho da chave de cada registro são calculados uma única vez e as comparações
+ * usam esses intervalos, sem copiar as chaves; os registros só são movidos no final.
+ *
+ * @param data Registros, um por elemento.
+ * @param opts Campo-chave e separador.
+ */
+void sort_records(std::vector<std::string>& data, const SortOptions& opts);
+
+/**
+ * @brief Chave inteira das primeiras k bases de uma sequência, com 3 bits por base.
+ *
+ * Os códigos (fim da sequência, A, C, G, demais caracteres, T) seguem a ordem dos bytes, de
+ * modo que a ordem das chaves é a ordem lexicográfica dos prefixos; N e os demais caracteres
+ * fora de ACGT ficam juntos entre G e T.
+ *
+ * @param seq Sequência.
+ * @param len Tamanho da sequência.
+ * @param k Número de bases (1 a MAX_KEY_PREFIX).
+ * @return Chave de 3k bits.
+ */
+uint64_t prefix_key(const char* seq, std::size_t len, int k);
+
+/**
+ * @brief Chave de prefixo (opts.key_prefix bases) de uma chave de to_sort_keys; com
+ *        opts.canonical, o marcador de orientação não faz parte do prefixo.
+ */
+inline uint64_t prefix_key(const std::string& key, const SortOptions& opts) {
+    std::size_t len = key.size() - (opts.canonical && !key.empty() ? 1 : 0);
+    return prefix_key(key.data(), len, opts.key_prefix);
+}
+
+/**
+ * @brief Ordena pelas primeiras opts.key_prefix bases, mantendo a ordem de entrada nos empates.
+ *
+ * As chaves de prefixo são calculadas uma única vez e ordenadas com as posições das sequências
+ * por radix sort LSD (estável), sem comparar strings; as sequências só são movidas no final.
+ *
+ * @param keys Sequências (chaves de to_sort_keys).
+ * @param opts Número de bases e forma canônica.
+ * @return Chaves de prefixo de keys, na nova ordem.
+ */
+std::vector<uint64_t> sort_by_prefix(std::vector<std::string>& keys, const SortOptions& opts);
+
+/**
+ * @brief Ordena chaves já convertidas por to_sort_keys: por prefixo, com opts.key_prefix, por campo, com
+ *        opts.key_field, ou com sequential_sort.
+ */
+void sort_keys(std::vector<std::string>& keys, const SortOptions& opts);
+
+/**
+ * @brief Ordena um vetor de sequências de DNA em ordem lexicográfica.
+ *
+ * Com sequências longas (tamanho médio de 256 bytes ou mais), usa sort_long_reads.
+ *
+ * @param data Vetor de strings representando sequências de DNA.
+ */
+void sequential_sort(std::vector<std::string>& data);
+
+/**
+ * @brief Ordenação lexicográfica para sequências longas (leituras de kilobases a megabases).
+ *
+ * As comparações usam palavras de 8 bytes das sequências, guardadas junto das posições, e não
+ * as strings: cada grupo de palavras iguais é ordenado de novo pela palavra seguinte, a partir
+ * do fim do prefixo comum a todo o grupo. Esse prefixo é medido com memcmp em blocos de tamanho
+ * dobrado. Grupos pequenos, ou que ficam com mais da metade do grupo anterior, são ordenados
+ * comparando as sequências com memcmp a partir desse prefixo. As sequências só são movidas no
+ * final, uma vez cada.
+ *
+ * @param data Sequências sem '\0'.
+ */
+void sort_long_reads(std::vector<std::string>& data);
+
+/**
+ * @brief Ordena em memória o intervalo [first, last) de acordo com as opções.
+ * @param first Início do intervalo.
+ * @param last Fim do intervalo.
+ * @param opts Opções de ordenação.
+ */
+void sort(std::string* first, std::string* last, const SortOptions& opts = SortOptions());
+
+/**
+ * @brief Ordena em memória um vetor de sequências de acordo com as opções.
+ * @param data Sequências a ordenar.
+ * @param opts Opções de ordenação.
+ */
+void sort(std::vector<std::string>& data, const SortOptions& opts = SortOptions());
+
+/**
+ * @brief Converte as sequências de [first, last) em chaves cuja ordem lexicográfica é a de opts.
+ *
+ * Aplica a chave canônica (se opts.canonical) e depois a política de opts.collation; não faz
+ * nada na ordem padrão.
+ */
+void to_sort_keys(std::string* first, std::string* last, const SortOptions& opts);
+
+/** @brief Versão de to_sort_keys para um vetor. */
+void to_sort_keys(std::vector<std::string>& data, const SortOptions& opts);
+
+/**
+ * @brief Recupera as sequências de [first, last) a partir das chaves de to_sort_keys.
+ */
+void from_sort_keys(std::string* first, std::string* last, const SortOptions& opts);
+
+/** @brief Versão de from_sort_keys para um vetor. */
+void from_sort_keys(std::vector<std::string>& data, const SortOptions& opts);
+
+/**
+ * @brief Converte pivôs (chaves de to_sort_keys) para a gravação em texto, desfazendo a política
+ *        de opts.collation: cada pivô volta a ser uma sequência legível. Com opts.canonical, o
+ *        pivô é a forma canônica, sem o marcador de orientação.
+ */
+void decode_pivots(std::vector<std::string>& pivots, const SortOptions& opts);
+
+/**
+ * @brief Converte pivôs gravados após decode_pivots de volta em chaves de to_sort_keys; com
+ *        opts.canonical, cada forma canônica recebe o marcador da orientação direta.
+ */
+void encode_pivots(std::vector<std::string>& pivots, const SortOptions& opts);
+
+/**
+ * @brief Lê arquivo texto com sequências de DNA e retorna vetor de strings.
+ * @param filename Nome do arquivo de entrada.
+ * @return Vetor de strings contendo as sequências de DNA.
+ */
+std::vector<std::string> read_file(const std::string& filename);
+
+/**
+ * @brief Escreve as sequências ordenadas em um arquivo texto.
+ * @param filename Nome do arquivo de saída.
+ * @param data Vetor de strings com as sequências ordenadas.
+ * @param index_block Se > 0, grava também o índice esparso (write_index) com blocos deste número de linhas.
+ */
+void write_file(const std::string& filename, const std::vector<std::string>& data, std::size_t index_block = 0);
+
+/**
+ * @brief Entrada do índice esparso: início de um bloco de linhas do arquivo ordenado.
+ */
+struct IndexEntry {
+    uint64_t offset;   ///< Deslocamento em bytes da primeira linha do bloco.
+    uint64_t line;     ///< Número (base 0) da primeira linha do bloco.
+    uint64_t key_pos;  ///< Posição da primeira linha do bloco na área de chaves.
+    uint64_t key_len;  ///< Tamanho da primeira linha do bloco.
+};
+
+/**
+ * @brief Grava o índice esparso "<filename>.idx" do arquivo gravado por write_file com data.
+ *
+ * Formato: "SIDX" (4 bytes), linhas por bloco, número de entradas, número de linhas e tamanho
+ * do arquivo de dados (uint64 cada), as entradas (IndexEntry) e a área de chaves com a primeira
+ * linha de cada bloco, na ordem de bytes nativa.
+ *
+ * @param filename Nome do arquivo de dados.
+ * @param data Sequências ordenadas, na ordem em que foram gravadas.
+ * @param block Linhas por bloco.
+ */
+void write_index(const std::string& filename, const std::vector<std::string>& data, std::size_t block);
+
+/**
+ * @brief Grava o índice esparso "<filename>.idx" a partir de entradas já calculadas.
+ * @param filename Nome do arquivo de dados.
+ * @param block Linhas por bloco.
+ * @param entries Entradas, uma por bloco (key_pos relativo a keys).
+ * @param keys Área de chaves (primeira linha de cada bloco, concatenadas).
+ * @param lines Número de linhas do arquivo de dados.
+ * @param bytes Tamanho do arquivo de dados.
+ */
+void write_index_entries(const std::string& filename, std::size_t block, const std::vector<IndexEntry>& entries,
+                         const std::string& keys, uint64_t lines, uint64_t bytes);
+
+/**
+ * @brief Calcula o reverso complementar de uma sequência.
+ * @param in Sequência de entrada.
+ * @param len Tamanho da sequência.
+ * @param out Buffer de saída com pelo menos len bytes.
+ */
+void reverse_complement(const char* in, std::size_t len, char* out);
+
+/**
+ * @brief Substitui a sequência pela sua chave canônica.
+ *
+ * A chave é a menor entre a sequência e seu reverso complementar, seguida de um marcador de
+ * orientação menor que qualquer base, de modo que a comparação lexicográfica das chaves
+ * equivale à comparação das formas canônicas.
+ *
+ * @param seq Sequência de DNA; recebe a chave canônica.
+ */
+void to_canonical_key(std::string& seq);
+
+/**
+ * @brief Recupera a sequência original a partir da chave canônica.
+ * @param key Chave canônica; recebe a sequência original.
+ */
+void from_canonical_key(std::string& key);
+
+} // namespace dnasort
+
+#endif // DNASORT_H
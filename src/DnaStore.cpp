@@ -0,0 +1,102 @@
+/**
+ * @file DnaStore.cpp
+ * @brief Programa de manutenção de um conjunto ordenado incremental de sequências de DNA.
+ *
+ * Cada arquivo acrescentado é ordenado e gravado como uma run imutável; as runs são
+ * compactadas por camadas em segundo plano e a exportação grava a visão intercalada de todas
+ * as runs. Assim, acrescentar um incremento diário custa apenas a ordenação do incremento,
+ * em vez da reordenação de todo o arquivo acumulado. O conjunto está em SortStore.h.
+ *
+ * Execução:
+ *   ./dna_store <diretório> append <arquivo_entrada>...
+ *   ./dna_store <diretório> export <arquivo_saida>
+ *   ./dna_store <diretório> compact [--all]
+ *   ./dna_store <diretório> info
+ *
+ * Comandos:
+ *   append  - Ordena cada arquivo e o acrescenta ao conjunto como uma nova run.
+ *   export  - Grava todas as sequências do conjunto, em ordem, em arquivo_saida.
+ *   compact - Executa as compactações pendentes (com --all, intercala todas as runs em uma).
+ *   info    - Lista as runs ativas, com tamanho, número de sequências e camada.
+ *
+ * append e compact obtêm o lock exclusivo do conjunto; export e info, o compartilhado.
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+
+#include "DnaSort.h"
+#include "SortStore.h"
+
+using namespace std;
+using namespace dnasort;
+
+/**
+ * @brief Segundos decorridos desde start.
+ */
+static double seconds_since(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Função principal. Executa um comando sobre o conjunto ordenado.
+ * @param argc Número de argumentos.
+ * @param argv Vetor de argumentos (diretório, comando e argumentos do comando).
+ * @return 0 em caso de sucesso, 1 em erro.
+ */
+int main(int argc, char** argv) {
+    string command = argc >= 3 ? argv[2] : "";
+    bool valid = (command == "append" && argc >= 4) || (command == "export" && argc == 4) ||
+                 (command == "compact" && (argc == 3 || (argc == 4 && string(argv[3]) == "--all"))) ||
+                 (command == "info" && argc == 3);
+    if (!valid) {
+        cerr << "Formato de execução: " << argv[0] << " <diretório> (append <arquivo_entrada>... | export <arquivo_saida> | compact [--all] | info)\n";
+        return 1;
+    }
+
+    try {
+        // export e info apenas leem: não removem arquivos e podem rodar ao mesmo tempo
+        StoreOptions store_opts;
+        store_opts.read_only = (command == "export" || command == "info");
+        SortStore store(argv[1], store_opts);
+        auto start = chrono::steady_clock::now();
+
+        if (command == "append") {
+            for (int i = 3; i < argc; i++) {
+                auto file_start = chrono::steady_clock::now();
+                vector<string> batch = read_file(argv[i]);
+                size_t n = batch.size();
+                store.append(batch);
+                cout << argv[i] << ": " << n << " sequências acrescentadas em " << seconds_since(file_start) << " segundos\n";
+            }
+            double append_time = seconds_since(start);
+            store.wait();
+            cout << "Compactação em segundo plano: " << (seconds_since(start) - append_time) << " segundos após o último append\n";
+        } else if (command == "export") {
+            uint64_t lines = store.export_file(argv[3]);
+            cout << lines << " sequências exportadas em " << seconds_since(start) << " segundos\n";
+        } else if (command == "compact") {
+            bool all = (argc == 4);
+            int rounds = 0;
+            while (store.compact(all)) rounds++;
+            cout << rounds << " compactação(ões) em " << seconds_since(start) << " segundos\n";
+        }
+
+        uint64_t total_lines = 0, total_bytes = 0;
+        vector<RunInfo> runs = store.runs();
+        for (const auto& r : runs) {
+            if (command == "info") cout << r.name << "\t" << r.bytes << " bytes\t" << r.lines << " sequências\tcamada " << store.tier(r.bytes) << "\n";
+            total_lines += r.lines;
+            total_bytes += r.bytes;
+        }
+        cout << runs.size() << " run(s), " << total_lines << " sequências, " << total_bytes << " bytes\n";
+
+    } catch (const exception& e) {
+        cerr << "Erro: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
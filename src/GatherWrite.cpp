@@ -0,0 +1,230 @@
+/**
+ * @file GatherWrite.cpp
+ * @brief Implementação da coleta com gravação em fluxo.
+ */
+
+#include "GatherWrite.h"
+
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "DnaSort.h"
+#include "Progress.h"
+
+using namespace std;
+
+namespace dnasort {
+
+#define GATHER_GRANT_TAG 30  ///< MASTER -> rank: pedido inicial e confirmação de cada bloco recebido.
+#define GATHER_SIZE_TAG 31   ///< rank -> MASTER: tamanho do próximo bloco (0 encerra).
+#define GATHER_DATA_TAG 32   ///< rank -> MASTER: bytes do bloco.
+#define GATHER_WINDOW 2      ///< Blocos em trânsito por rank.
+
+namespace {
+
+/**
+ * @brief Thread de gravação: grava os blocos na ordem de chegada, com no máximo dois na fila.
+ *
+ * Com index_block > 0, também calcula as entradas do índice esparso a partir das linhas dos blocos.
+ */
+class ChunkWriter {
+public:
+    ChunkWriter(const string& filename, size_t index_block)
+        : file_(filename, ios::binary), index_block_(index_block), opened_(file_.is_open()), done_(false),
+          ok_(opened_), bytes_(0), lines_(0) {
+        thread_ = thread([this] { loop(); });
+    }
+
+    ~ChunkWriter() {
+        if (thread_.joinable()) finish();
+    }
+
+    bool is_open() const { return opened_; }
+
+    /**
+     * @brief Entrega um bloco para gravação; chunk recebe um buffer livre (possivelmente reutilizado).
+     */
+    void push(vector<char>& chunk) {
+        unique_lock<mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return queue_.size() < GATHER_WINDOW; });
+        queue_.push_back(vector<char>());
+        queue_.back().swap(chunk);
+        if (!free_.empty()) {
+            chunk.swap(free_.back());
+            free_.pop_back();
+        }
+        chunk.clear();
+        not_empty_.notify_one();
+    }
+
+    /**
+     * @brief Aguarda a gravação dos blocos pendentes e fecha o arquivo.
+     * @return false se houve erro de gravação.
+     */
+    bool finish() {
+        {
+            lock_guard<mutex> lock(mutex_);
+            done_ = true;
+            not_empty_.notify_one();
+        }
+        thread_.join();
+        file_.close();
+        return ok_ && !file_.fail();
+    }
+
+    uint64_t bytes() const { return bytes_; }
+
+    const vector<IndexEntry>& entries() const { return entries_; }
+    const string& keys() const { return keys_; }
+    uint64_t lines() const { return lines_; }
+
+private:
+    void loop() {
+        vector<char> chunk;
+        for (;;) {
+            {
+                unique_lock<mutex> lock(mutex_);
+                if (chunk.capacity() > 0) free_.push_back(move(chunk));
+                not_empty_.wait(lock, [this] { return done_ || !queue_.empty(); });
+                if (queue_.empty()) return;
+                chunk.swap(queue_.front());
+                queue_.pop_front();
+                not_full_.notify_one();
+            }
+            if (index_block_ > 0) index_lines(chunk);
+            if (ok_ && !file_.write(chunk.data(), chunk.size())) ok_ = false;
+            bytes_ += chunk.size();
+        }
+    }
+
+    /**
+     * @brief Registra no índice as linhas de início de bloco contidas em chunk (linhas completas).
+     */
+    void index_lines(const vector<char>& chunk) {
+        const char* data = chunk.data();
+        size_t pos = 0;
+        while (pos < chunk.size()) {
+            const char* nl = (const char*)memchr(data + pos, '\n', chunk.size() - pos);
+            size_t len = (nl ? nl - data : chunk.size()) - pos;
+            if (lines_ % index_block_ == 0) {
+                entries_.push_back(IndexEntry{bytes_ + pos, lines_, keys_.size(), len});
+                keys_.append(data + pos, len);
+            }
+            lines_++;
+            pos += len + 1;
+        }
+    }
+
+    ofstream file_;
+    size_t index_block_;
+    const bool opened_;
+    thread thread_;
+    mutex mutex_;
+    condition_variable not_empty_, not_full_;
+    deque<vector<char>> queue_;
+    vector<vector<char>> free_;
+    bool done_;
+    bool ok_;
+    uint64_t bytes_;
+    vector<IndexEntry> entries_;
+    string keys_;
+    uint64_t lines_;
+};
+
+/**
+ * @brief Acrescenta a chunk as linhas de local a partir de next, até chunk_bytes bytes (ao menos uma linha).
+ * @return Índice da primeira sequência não incluída.
+ */
+size_t fill_chunk(const vector<string>& local, size_t next, size_t chunk_bytes, vector<char>& chunk) {
+    chunk.clear();
+    while (next < local.size() && (chunk.empty() || chunk.size() + local[next].size() + 1 <= chunk_bytes)) {
+        chunk.insert(chunk.end(), local[next].begin(), local[next].end());
+        chunk.push_back('\n');
+        next++;
+    }
+    return next;
+}
+
+} // namespace
+
+uint64_t gather_write(Comm& comm, const vector<string>& local, const string& filename,
+                      size_t chunk_bytes, size_t index_block) {
+    int rank = comm.rank(), size = comm.size();
+    uint64_t grant = 1;
+
+    if (rank != MASTER) {
+        // Aguarda a vez deste rank e envia os blocos, com no máximo GATHER_WINDOW sem confirmação
+        uint64_t go;
+        comm.recv(&go, sizeof(go), MASTER, GATHER_GRANT_TAG);
+        uint64_t sent = 0, acked = 0;
+        vector<char> chunk;
+        if (go) {
+            for (size_t next = 0; next < local.size(); sent++) {
+                if (sent - acked >= GATHER_WINDOW) {
+                    comm.recv(&grant, sizeof(grant), MASTER, GATHER_GRANT_TAG);
+                    acked++;
+                }
+                size_t first = next;
+                next = fill_chunk(local, next, chunk_bytes, chunk);
+                uint64_t bytes = chunk.size();
+                comm.send(&bytes, sizeof(bytes), MASTER, GATHER_SIZE_TAG);
+                comm.send(chunk.data(), bytes, MASTER, GATHER_DATA_TAG);
+                progress_advance(next - first, bytes);
+            }
+            uint64_t end = 0;
+            comm.send(&end, sizeof(end), MASTER, GATHER_SIZE_TAG);
+            for (; acked < sent; acked++) comm.recv(&grant, sizeof(grant), MASTER, GATHER_GRANT_TAG);
+        }
+        uint64_t failed;
+        comm.bcast(&failed, sizeof(failed), MASTER);
+        if (failed) throw runtime_error("Erro ao gravar o arquivo de saída: " + filename);
+        return 0;
+    }
+
+    ChunkWriter writer(filename, index_block);
+    uint64_t go = writer.is_open();
+
+    // Partição do MASTER
+    vector<char> chunk;
+    for (size_t next = 0; go && next < local.size(); ) {
+        size_t first = next;
+        next = fill_chunk(local, next, chunk_bytes, chunk);
+        uint64_t bytes = chunk.size();
+        writer.push(chunk);
+        progress_advance(next - first, bytes);
+    }
+
+    // Partições dos demais ranks, em ordem, bloco a bloco
+    for (int p = 1; p < size; p++) {
+        comm.send(&go, sizeof(go), p, GATHER_GRANT_TAG);
+        if (!go) continue;
+        for (;;) {
+            uint64_t bytes;
+            comm.recv(&bytes, sizeof(bytes), p, GATHER_SIZE_TAG);
+            if (bytes == 0) break;
+            chunk.resize(bytes);
+            comm.recv(chunk.data(), bytes, p, GATHER_DATA_TAG);
+            comm.send(&grant, sizeof(grant), p, GATHER_GRANT_TAG);
+            writer.push(chunk);
+        }
+    }
+
+    uint64_t failed = !writer.finish();
+    if (!failed && index_block > 0) {
+        try {
+            write_index_entries(filename, index_block, writer.entries(), writer.keys(), writer.lines(), writer.bytes());
+        } catch (const exception&) {
+            failed = 1;
+        }
+    }
+    comm.bcast(&failed, sizeof(failed), MASTER);
+    if (failed) throw runtime_error("Erro ao gravar o arquivo de saída: " + filename);
+    return writer.bytes();
+}
+
+} // namespace dnasort
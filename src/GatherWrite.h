@@ -0,0 +1,42 @@
+/**
+ * @file GatherWrite.h
+ * @brief Coleta das partições ordenadas no MASTER com gravação em fluxo, em blocos limitados.
+ *
+ * A coleta com gather_strings materializa todo o resultado no MASTER antes da gravação.
+ * gather_write grava a partição do MASTER e, em seguida, pede a cada rank, em ordem, a sua
+ * partição em blocos de no máximo chunk_bytes bytes (ou uma linha, se maior), com no máximo
+ * dois blocos em trânsito por rank. Uma thread grava o bloco anterior enquanto o próximo é
+ * recebido, de modo que a rede e o disco trabalham ao mesmo tempo e a memória extra do
+ * MASTER é O(chunk_bytes).
+ */
+
+#ifndef GATHER_WRITE_H
+#define GATHER_WRITE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Comm.h"
+
+namespace dnasort {
+
+/**
+ * @brief Grava em filename as partições de todos os ranks, em ordem de rank, uma sequência por linha.
+ *
+ * Coletiva; o arquivo gerado é igual ao de write_file com a concatenação das partições.
+ * Lança runtime_error em todos os ranks se o MASTER não conseguir gravar.
+ *
+ * @param comm Comunicador.
+ * @param local Partição local.
+ * @param filename Nome do arquivo de saída (gravado pelo MASTER).
+ * @param chunk_bytes Tamanho máximo de cada bloco transferido.
+ * @param index_block Se > 0, grava também o índice esparso da saída (write_index).
+ * @return Número de bytes gravados (no MASTER; 0 nos demais).
+ */
+uint64_t gather_write(Comm& comm, const std::vector<std::string>& local, const std::string& filename,
+                      std::size_t chunk_bytes, std::size_t index_block = 0);
+
+} // namespace dnasort
+
+#endif // GATHER_WRITE_H
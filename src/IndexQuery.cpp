@@ -0,0 +1,119 @@
+/**
+ * @file IndexQuery.cpp
+ * @brief Programa de consultas por busca binária em um arquivo ordenado com índice esparso.
+ *
+ * O arquivo de dados e o índice "<arquivo>.idx" (gravado com --index B pelos programas de
+ * ordenação ou com --build B por este programa) são mapeados em memória; cada consulta faz uma
+ * busca binária nas chaves do índice e percorre no máximo um bloco de B linhas, sem ler o
+ * restante do arquivo. O índice está em SortedIndex.h.
+ *
+ * Execução:
+ *   ./index_query <arquivo_ordenado> [--build B] [consulta...]
+ *
+ * Consultas (pares "tipo valor"; sem consultas na linha de comando, uma por linha da entrada padrão):
+ *   exact SEQ  - Imprime "SEQ<tab>n", com n o número de ocorrências exatas de SEQ.
+ *   count P    - Imprime "P*<tab>n", com n o número de sequências com prefixo P.
+ *   prefix P   - Imprime as sequências com prefixo P, em ordem.
+ *
+ * Ao final, o tempo médio por consulta é impresso na saída de erro.
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
+
+#include "SortedIndex.h"
+
+using namespace std;
+using namespace dnasort;
+
+/**
+ * @brief Executa uma consulta e imprime o resultado.
+ * @param index Arquivo ordenado com índice.
+ * @param type Tipo da consulta ("exact", "count" ou "prefix").
+ * @param value Sequência ou prefixo consultado.
+ * @param out Saída do resultado.
+ * @return false se o tipo da consulta é desconhecido.
+ */
+static bool run_query(const SortedIndex& index, const string& type, const string& value, ostream& out) {
+    if (type == "exact") {
+        out << value << "\t" << index.count(value) << "\n";
+    } else if (type == "count") {
+        out << value << "*\t" << index.count_prefix(value) << "\n";
+    } else if (type == "prefix") {
+        index.visit(index.lower_bound(value), index.prefix_end(value), [&](const LineRef& line) {
+            out.write(line.data, line.len);
+            out << "\n";
+        });
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Função principal. Abre o arquivo indexado e executa as consultas.
+ * @param argc Número de argumentos.
+ * @param argv Vetor de argumentos (arquivo, opção --build e consultas).
+ * @return 0 em caso de sucesso, 1 em erro.
+ */
+int main(int argc, char** argv) {
+    int first_query = 2;
+    long build_block = 0;
+    if (argc >= 4 && string(argv[2]) == "--build") {
+        build_block = atol(argv[3]);
+        first_query = 4;
+    }
+    if (argc < 2 || (first_query == 4 && build_block <= 0) || (argc - first_query) % 2 != 0) {
+        cerr << "Formato de execução: " << argv[0] << " <arquivo_ordenado> [--build B] [(exact SEQ | count P | prefix P)...]\n";
+        return 1;
+    }
+
+    try {
+        const string filename = argv[1];
+        if (build_block > 0) {
+            auto build_start = chrono::steady_clock::now();
+            build_index(filename, build_block);
+            chrono::duration<double> elapsed = chrono::steady_clock::now() - build_start;
+            cerr << "Índice gravado em " << elapsed.count() << " segundos\n";
+        }
+
+        SortedIndex index(filename);
+
+        // Consultas da linha de comando ou da entrada padrão
+        vector<pair<string, string>> queries;
+        for (int i = first_query; i < argc; i += 2) queries.push_back(make_pair(argv[i], argv[i + 1]));
+        if (queries.empty() && build_block == 0) {
+            string line, type, value;
+            while (getline(cin, line)) {
+                istringstream fields(line);
+                if (fields >> type >> value) queries.push_back(make_pair(type, value));
+            }
+        }
+
+        // Resultados acumulados em memória para que o tempo medido seja o das buscas
+        ostringstream out;
+        auto start = chrono::steady_clock::now();
+        for (const auto& q : queries) {
+            if (!run_query(index, q.first, q.second, out)) {
+                cerr << "Consulta desconhecida: " << q.first << "\n";
+                return 1;
+            }
+        }
+        chrono::duration<double, micro> elapsed = chrono::steady_clock::now() - start;
+        cout << out.str();
+
+        if (!queries.empty()) {
+            cerr << queries.size() << " consulta(s) em " << index.lines() << " sequências: "
+                 << elapsed.count() / queries.size() << " µs por consulta\n";
+        }
+    } catch (const exception& e) {
+        cerr << "Erro: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -3,26 +3,38 @@
 #include <string.h>
 #include <time.h>
 
+#define MIN_SEQ_LENGTH 10
 #define MAX_SEQ_LENGTH 100
 #define DNA_CHARS "ACGT"
 
-void generate_dna_sequence(char* seq, int length) {
-    for (int i = 0; i < length; i++) {
+void generate_dna_sequence(char* seq, long length) {
+    for (long i = 0; i < length; i++) {
         seq[i] = DNA_CHARS[rand() % 4];
     }
     seq[length] = '\0';
 }
 
 int main(int argc, char* argv[]) {
-    if (argc != 3) {
+    if (argc != 3 && argc != 5) {
         printf("Falha ao rodar o programa: quantidade inválida de argumentos\n");
-        printf("Formato de execução: %s <número_de_sequências> <nome_arquivo_saída>\n", argv[0]);
+        printf("Formato de execução: %s <número_de_sequências> <nome_arquivo_saída> [<tamanho_mínimo> <tamanho_máximo>]\n", argv[0]);
         return 1;
     }
 
     int num_sequences = atoi(argv[1]);
     char* output_filename = argv[2];
 
+    // Tamanhos das sequências (padrão entre 10 e 100; leituras longas, por exemplo 10000 1000000)
+    long min_length = MIN_SEQ_LENGTH, max_length = MAX_SEQ_LENGTH;
+    if (argc == 5) {
+        min_length = atol(argv[3]);
+        max_length = atol(argv[4]);
+        if (min_length < 1 || max_length < min_length) {
+            printf("Falha ao rodar o programa: tamanhos inválidos\n");
+            return 1;
+        }
+    }
+
     srand(time(NULL));
 
     FILE* file = fopen(output_filename, "w");
@@ -31,15 +43,22 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    char sequence[MAX_SEQ_LENGTH + 1];
+    char* sequence = malloc(max_length + 1);
+    if (sequence == NULL) {
+        perror("Error allocating sequence buffer");
+        fclose(file);
+        return 1;
+    }
 
     for (int i = 0; i < num_sequences; i++) {
-        // Sequência aleatória entre 10 e 100
-        int length = (rand() % 91) + 10; 
+        // Sequência aleatória entre min_length e max_length (rand() pode ter apenas 15 bits)
+        long span = max_length - min_length + 1;
+        long length = min_length + (long)(((unsigned long)rand() * ((unsigned long)RAND_MAX + 1) + rand()) % span);
         generate_dna_sequence(sequence, length);
         fprintf(file, "%s\n", sequence);
     }
 
+    free(sequence);
     fclose(file);
     printf("%d sequências de DNA geradas e salvadas em %s\n", num_sequences, output_filename);
 
@@ -0,0 +1,92 @@
+/**
+ * @file JobQueue.cpp
+ * @brief Implementação da fila de jobs em diretório.
+ */
+
+#include "JobQueue.h"
+
+#include <dirent.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+namespace dnasort {
+
+static const string JOB_SUFFIX = ".job";
+
+/**
+ * @brief Lê o arquivo de um job e preenche os argumentos (ou a mensagem de erro).
+ */
+static void read_job(const string& path, Job& job) {
+    ifstream file(path);
+    if (!file.is_open()) { job.error = "Erro ao abrir o job: " + path; return; }
+
+    string input, output, options, line;
+    while (getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        size_t eq = line.find('=');
+        string key = line.substr(0, eq), value = (eq == string::npos) ? "" : line.substr(eq + 1);
+        if (key == "input") input = value;
+        else if (key == "output") output = value;
+        else if (key == "options") options = value;
+        else { job.error = "Chave desconhecida no job: " + key; return; }
+    }
+    if (input.empty() || output.empty()) { job.error = "Job sem input ou output"; return; }
+
+    job.args.push_back(input);
+    job.args.push_back(output);
+    istringstream tokens(options);
+    string token;
+    while (tokens >> token) job.args.push_back(token);
+}
+
+bool claim_job(const string& dir, Job& job) {
+    DIR* d = opendir(dir.c_str());
+    if (!d) return false;
+    vector<string> names;
+    while (dirent* entry = readdir(d)) {
+        string name = entry->d_name;
+        if (name.size() > JOB_SUFFIX.size() &&
+            name.compare(name.size() - JOB_SUFFIX.size(), JOB_SUFFIX.size(), JOB_SUFFIX) == 0) {
+            names.push_back(name.substr(0, name.size() - JOB_SUFFIX.size()));
+        }
+    }
+    closedir(d);
+    std::sort(names.begin(), names.end());
+
+    for (const auto& name : names) {
+        string pending = dir + "/" + name + JOB_SUFFIX, running = dir + "/" + name + ".running";
+        // link não substitui um .running existente (ao contrário de rename): falha se outro grupo
+        // reivindicou o job primeiro ou se um job com o mesmo nome ainda está em execução, e
+        // nesse caso o job fica na fila até o término do anterior
+        if (link(pending.c_str(), running.c_str()) != 0) continue;
+        unlink(pending.c_str());
+        job = Job();
+        job.name = name;
+        read_job(running, job);
+        return true;
+    }
+    return false;
+}
+
+bool stop_requested(const string& dir) {
+    return access((dir + "/STOP").c_str(), F_OK) == 0;
+}
+
+void finish_job(const string& dir, const Job& job, bool ok, const string& report) {
+    string base = dir + "/" + job.name;
+    string result = base + (ok ? ".done" : ".failed");
+    {
+        ofstream file(result + ".tmp");
+        file << report;
+    }
+    rename((result + ".tmp").c_str(), result.c_str());
+    unlink((base + ".running").c_str());
+}
+
+} // namespace dnasort
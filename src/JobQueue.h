@@ -0,0 +1,60 @@
+/**
+ * @file JobQueue.h
+ * @brief Fila de jobs em diretório usada pelo modo serviço (--daemon) do SampleSort.
+ *
+ * Cada job é um arquivo "<nome>.job" com linhas "chave=valor":
+ *   input=<arquivo_entrada>
+ *   output=<arquivo_saida>
+ *   options=<opções do SampleSort separadas por espaço>   (opcional)
+ * Linhas vazias ou iniciadas por '#' são ignoradas. Um job é reivindicado criando o hard link
+ * "<nome>.running" e removendo "<nome>.job" (link falha se o destino existe, então cada job é
+ * executado por um único grupo) e, ao terminar, o resultado é gravado em "<nome>.done" ou "<nome>.failed". Um arquivo "STOP" no
+ * diretório encerra o serviço.
+ */
+
+#ifndef JOB_QUEUE_H
+#define JOB_QUEUE_H
+
+#include <string>
+#include <vector>
+
+namespace dnasort {
+
+/**
+ * @brief Job reivindicado da fila.
+ */
+struct Job {
+    std::string name;               ///< Nome do arquivo sem a extensão ".job".
+    std::vector<std::string> args;  ///< Entrada, saída e opções, como na linha de comando.
+    std::string error;              ///< Não vazio se o arquivo do job é inválido.
+};
+
+/**
+ * @brief Reivindica o próximo job da fila (em ordem alfabética de nome).
+ *
+ * Um job cujo nome já está em execução (<nome>.running) não é reivindicado e fica na fila até o
+ * término do anterior, de modo que dois grupos nunca executam o mesmo nome ao mesmo tempo.
+ *
+ * @param dir Diretório da fila.
+ * @param job Recebe o job reivindicado.
+ * @return true se um job foi reivindicado, false se a fila está vazia.
+ */
+bool claim_job(const std::string& dir, Job& job);
+
+/**
+ * @brief Verifica se o arquivo STOP existe no diretório da fila.
+ */
+bool stop_requested(const std::string& dir);
+
+/**
+ * @brief Grava o resultado de um job em "<nome>.done" ou "<nome>.failed" e remove "<nome>.running".
+ * @param dir Diretório da fila.
+ * @param job Job executado.
+ * @param ok Se o job terminou com sucesso.
+ * @param report Conteúdo do arquivo de resultado (linhas "chave=valor").
+ */
+void finish_job(const std::string& dir, const Job& job, bool ok, const std::string& report);
+
+} // namespace dnasort
+
+#endif // JOB_QUEUE_H
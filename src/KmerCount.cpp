@@ -0,0 +1,107 @@
+/**
+ * @file KmerCount.cpp
+ * @brief Implementação da contagem distribuída de k-mers.
+ */
+
+#include "KmerCount.h"
+
+#include <fstream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace dnasort {
+
+void radix_sort_u64(vector<uint64_t>& data, int bits) {
+    vector<uint64_t> buffer(data.size());
+    for (int shift = 0; shift < bits; shift += 8) {
+        size_t count[257] = {0};
+        for (uint64_t v : data) count[((v >> shift) & 0xFF) + 1]++;
+        for (int d = 0; d < 256; d++) count[d + 1] += count[d];
+        for (uint64_t v : data) buffer[count[(v >> shift) & 0xFF]++] = v;
+        data.swap(buffer);
+    }
+}
+
+vector<KmerCount> count_local_kmers(const vector<string>& data, int k, bool canonical) {
+    const uint64_t mask = (k == 32) ? ~0ULL : ((1ULL << (2 * k)) - 1);
+    const int top_shift = 2 * (k - 1);
+
+    vector<uint64_t> kmers;
+    for (const auto& seq : data) {
+        uint64_t fwd = 0, rev = 0;
+        int valid = 0;
+        for (char c : seq) {
+            int b = encode_base(c);
+            if (b < 0) { valid = 0; continue; }
+            fwd = ((fwd << 2) | b) & mask;
+            rev = (rev >> 2) | ((uint64_t)(3 - b) << top_shift);
+            if (++valid >= k) kmers.push_back(canonical ? min(fwd, rev) : fwd);
+        }
+    }
+    radix_sort_u64(kmers, 2 * k);
+
+    vector<KmerCount> counts;
+    for (size_t i = 0; i < kmers.size();) {
+        size_t j = i;
+        while (j < kmers.size() && kmers[j] == kmers[i]) j++;
+        counts.push_back(KmerCount{kmers[i], j - i});
+        i = j;
+    }
+    return counts;
+}
+
+void merge_kmer_counts(vector<KmerCount>& counts) {
+    std::sort(counts.begin(), counts.end());
+    size_t out = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        if (out > 0 && counts[out - 1].kmer == counts[i].kmer) counts[out - 1].count += counts[i].count;
+        else counts[out++] = counts[i];
+    }
+    counts.resize(out);
+}
+
+vector<KmerCount> count_kmers(Comm& comm, vector<string>& local, int k, bool canonical, KmerStats* stats) {
+    // Extração e contagem local
+    double local_count_start = comm.wtime();
+    vector<KmerCount> local_counts = count_local_kmers(local, k, canonical);
+    vector<string>().swap(local);
+    double local_count_end = comm.wtime();
+
+    // Pivôs a partir das contagens locais ordenadas, particionamento por faixas e troca
+    double exchange_start = comm.wtime();
+    vector<KmerCount> pivots = sample_pivots(comm, local_counts);
+    vector<KmerCount> received = exchange_sorted(comm, local_counts, pivots);
+    vector<KmerCount>().swap(local_counts);
+    double exchange_end = comm.wtime();
+
+    // Soma das contagens parciais
+    double merge_start = comm.wtime();
+    merge_kmer_counts(received);
+    double merge_end = comm.wtime();
+
+    if (stats) {
+        stats->local_count = local_count_end - local_count_start;
+        stats->exchange = exchange_end - exchange_start;
+        stats->merge = merge_end - merge_start;
+    }
+    return received;
+}
+
+void write_kmer_file(const string& filename, int k, const vector<KmerCount>& counts) {
+    ofstream file(filename, ios::binary);
+    if (!file.is_open()) {throw runtime_error("Erro ao abrir o arquivo de saída: " + filename);}
+
+    uint32_t k32 = k;
+    uint64_t n = counts.size();
+    file.write("KMER", 4);
+    file.write((const char*)&k32, sizeof(k32));
+    file.write((const char*)&n, sizeof(n));
+    for (const auto& c : counts) {
+        file.write((const char*)&c.kmer, sizeof(c.kmer));
+        file.write((const char*)&c.count, sizeof(c.count));
+    }
+    file.close();
+}
+
+} // namespace dnasort
@@ -0,0 +1,111 @@
+/**
+ * @file KmerCount.h
+ * @brief Contagem distribuída de k-mers sobre o particionamento por faixas do Sample Sort.
+ */
+
+#ifndef KMER_COUNT_H
+#define KMER_COUNT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ParallelSort.h"
+
+namespace dnasort {
+
+/**
+ * @brief Par (k-mer, contagem) com o k-mer codificado em 2 bits por base.
+ */
+struct KmerCount {
+    uint64_t kmer;
+    uint64_t count;
+
+    bool operator<(const KmerCount& other) const { return kmer < other.kmer; }
+};
+
+/**
+ * @brief Tempos das fases da contagem distribuída, em segundos.
+ */
+struct KmerStats {
+    double local_count = 0;  ///< Extração, ordenação e agregação locais.
+    double exchange = 0;     ///< Amostras, pivôs e troca por faixas.
+    double merge = 0;        ///< Soma das contagens parciais recebidas.
+};
+
+/**
+ * @brief Código de 2 bits de uma base (A=0, C=1, G=2, T=3).
+ * @param c Base.
+ * @return Código da base, ou -1 para caracteres fora do alfabeto ACGT.
+ */
+inline int encode_base(char c) {
+    switch (c) {
+        case 'A': return 0;
+        case 'C': return 1;
+        case 'G': return 2;
+        case 'T': return 3;
+        default:  return -1;
+    }
+}
+
+/**
+ * @brief Ordena inteiros de 64 bits por radix sort LSD com dígitos de 8 bits.
+ * @param data Vetor a ordenar.
+ * @param bits Quantidade de bits significativos das chaves.
+ */
+void radix_sort_u64(std::vector<uint64_t>& data, int bits);
+
+/**
+ * @brief Extrai e conta os k-mers de uma partição local.
+ *
+ * Os k-mers são extraídos com janela deslizante em 2 bits por base (k-mers contendo
+ * caracteres fora de ACGT são ignorados), ordenados com radix sort e agregados em pares
+ * (k-mer, contagem).
+ *
+ * @param data Sequências locais.
+ * @param k Tamanho dos k-mers (1 a 32).
+ * @param canonical Se true, conta o menor entre o k-mer e seu reverso complementar.
+ * @return Pares (k-mer, contagem) ordenados por k-mer.
+ */
+std::vector<KmerCount> count_local_kmers(const std::vector<std::string>& data, int k, bool canonical);
+
+/**
+ * @brief Soma as contagens de pares com o mesmo k-mer.
+ * @param counts Pares (k-mer, contagem), possivelmente repetidos; recebe os pares únicos ordenados.
+ */
+void merge_kmer_counts(std::vector<KmerCount>& counts);
+
+/**
+ * @brief Contagem distribuída de k-mers.
+ *
+ * Cada processo conta localmente seus k-mers; as contagens locais ordenadas são amostradas
+ * e particionadas por faixas com os mesmos passos do Sample Sort (amostras, pivôs no MASTER,
+ * broadcast e troca), de modo que cada k-mer termina em um único processo, onde as contagens
+ * parciais são somadas.
+ *
+ * @param comm Comunicador dos processos participantes.
+ * @param local Partição local de sequências (é esvaziada).
+ * @param k Tamanho dos k-mers (1 a 32).
+ * @param canonical Se true, conta cada k-mer pela sua forma canônica.
+ * @param stats Se não nulo, recebe os tempos das fases.
+ * @return Pares (k-mer, contagem) locais; as partições estão em ordem crescente de rank.
+ */
+std::vector<KmerCount> count_kmers(Comm& comm, std::vector<std::string>& local, int k, bool canonical,
+                                   KmerStats* stats = 0);
+
+/**
+ * @brief Grava pares (k-mer, contagem) em formato binário.
+ *
+ * Formato: "KMER" (4 bytes), k (uint32), quantidade de pares (uint64) e, para cada par,
+ * k-mer (uint64, 2 bits por base, A=0 C=1 G=2 T=3, primeira base nos bits mais altos)
+ * e contagem (uint64), na ordem de bytes nativa.
+ *
+ * @param filename Nome do arquivo de saída.
+ * @param k Tamanho dos k-mers.
+ * @param counts Pares ordenados por k-mer.
+ */
+void write_kmer_file(const std::string& filename, int k, const std::vector<KmerCount>& counts);
+
+} // namespace dnasort
+
+#endif // KMER_COUNT_H
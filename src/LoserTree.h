@@ -0,0 +1,106 @@
+/**
+ * @file LoserTree.h
+ * @brief Árvore de perdedores para intercalação de k sequências ordenadas.
+ */
+
+#ifndef LOSER_TREE_H
+#define LOSER_TREE_H
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace dnasort {
+
+/**
+ * @brief Árvore de perdedores (tournament tree) sobre k fontes ordenadas.
+ *
+ * Cada nó interno guarda o perdedor da disputa entre as suas subárvores e a raiz guarda o
+ * vencedor, de modo que trocar a chave do vencedor custa apenas log2(k) comparações, uma por
+ * nível, sem comparar com o irmão como no heap. Fontes esgotadas perdem para qualquer chave;
+ * chaves iguais são desempatadas pelo índice da fonte, o que torna a intercalação estável.
+ *
+ * Uso:
+ *   LoserTree<T> tree(k);
+ *   for (int i = 0; i < k; i++) if (!fonte[i].vazia()) tree.set(i, primeira chave de i);
+ *   tree.build();
+ *   while (!tree.empty()) {
+ *       int i = tree.top();  // consome tree.top_key()
+ *       if (fonte i tem mais chaves) tree.replace_top(próxima chave de i); else tree.pop_top();
+ *   }
+ */
+template <typename T, typename Less = std::less<T>>
+class LoserTree {
+public:
+    explicit LoserTree(int k, Less less = Less())
+        : k_(k), less_(less), keys_(k), done_(k, true), tree_(2 * k, 0) {}
+
+    /** @brief Define a primeira chave da fonte i (antes de build). */
+    void set(int i, const T& key) {
+        keys_[i] = key;
+        done_[i] = false;
+    }
+
+    /** @brief Monta a árvore a partir das chaves definidas com set. */
+    void build() {
+        if (k_ > 0) tree_[0] = play(1);
+    }
+
+    /** @brief true quando todas as fontes estão esgotadas. */
+    bool empty() const { return k_ == 0 || done_[tree_[0]]; }
+
+    /** @brief Fonte com a menor chave atual. */
+    int top() const { return tree_[0]; }
+
+    /** @brief Menor chave atual. */
+    const T& top_key() const { return keys_[tree_[0]]; }
+
+    /** @brief Substitui a chave da fonte vencedora pela sua próxima chave. */
+    void replace_top(const T& key) {
+        keys_[tree_[0]] = key;
+        adjust(tree_[0]);
+    }
+
+    /** @brief Marca a fonte vencedora como esgotada. */
+    void pop_top() {
+        done_[tree_[0]] = true;
+        adjust(tree_[0]);
+    }
+
+private:
+    /** @brief true se a fonte a vence a fonte b. */
+    bool beats(int a, int b) const {
+        if (done_[a] || done_[b]) return done_[b] && (!done_[a] || a < b);
+        if (less_(keys_[a], keys_[b])) return true;
+        if (less_(keys_[b], keys_[a])) return false;
+        return a < b;
+    }
+
+    /** @brief Disputa da subárvore do nó; guarda o perdedor e devolve o vencedor. */
+    int play(int node) {
+        if (node >= k_) return node - k_;
+        int left = play(2 * node), right = play(2 * node + 1);
+        if (beats(left, right)) { tree_[node] = right; return left; }
+        tree_[node] = left;
+        return right;
+    }
+
+    /** @brief Refaz as disputas do caminho da folha da fonte s até a raiz. */
+    void adjust(int s) {
+        int winner = s;
+        for (int node = (s + k_) / 2; node > 0; node /= 2) {
+            if (beats(tree_[node], winner)) std::swap(tree_[node], winner);
+        }
+        tree_[0] = winner;
+    }
+
+    int k_;
+    Less less_;
+    std::vector<T> keys_;
+    std::vector<bool> done_;
+    std::vector<int> tree_;
+};
+
+} // namespace dnasort
+
+#endif // LOSER_TREE_H
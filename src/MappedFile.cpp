@@ -0,0 +1,60 @@
+/**
+ * @file MappedFile.cpp
+ * @brief Implementação do arquivo mapeado em memória e da busca binária por linhas.
+ */
+
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdexcept>
+
+using namespace std;
+
+namespace dnasort {
+
+MappedFile::MappedFile(const string& filename) : data_(0), size_(0) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {throw runtime_error("Erro ao abrir o arquivo de entrada: " + filename);}
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw runtime_error("Erro ao abrir o arquivo de entrada: " + filename);
+    }
+    size_ = st.st_size;
+    if (size_ > 0) {
+        void* p = mmap(0, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            close(fd);
+            throw runtime_error("Erro ao mapear o arquivo de entrada: " + filename);
+        }
+        madvise(p, size_, MADV_SEQUENTIAL);
+        data_ = (const char*)p;
+    }
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data_) munmap((void*)data_, size_);
+}
+
+size_t search_lines(const char* data, size_t size, size_t lo, size_t hi, const LineRef& key, bool upper) {
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        // Início da linha que contém mid (lo é início de linha)
+        const char* nl = (const char*)memrchr(data + lo, '\n', mid - lo);
+        size_t pos = nl ? (nl - data) + 1 : lo;
+
+        LineRef line = line_at(data, size, pos);
+        bool go_right = upper ? !(key < line) : (line < key);
+        if (go_right) lo = next_line(data, size, pos);
+        else hi = pos;
+    }
+    return lo;
+}
+
+} // namespace dnasort
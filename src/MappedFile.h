@@ -0,0 +1,86 @@
+/**
+ * @file MappedFile.h
+ * @brief Arquivo mapeado em memória (somente leitura) e busca binária sobre arquivos de linhas ordenadas.
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+namespace dnasort {
+
+/**
+ * @brief Mapeia um arquivo inteiro em memória com mmap, somente leitura.
+ */
+class MappedFile {
+public:
+    /**
+     * @param filename Nome do arquivo; lança runtime_error se não puder ser aberto.
+     */
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    const char* data_;
+    std::size_t size_;
+};
+
+/**
+ * @brief Referência a uma linha dentro de um buffer (sem o '\n').
+ */
+struct LineRef {
+    const char* data;
+    std::size_t len;
+
+    bool operator<(const LineRef& other) const {
+        int c = std::memcmp(data, other.data, len < other.len ? len : other.len);
+        return c < 0 || (c == 0 && len < other.len);
+    }
+};
+
+/**
+ * @brief Início da próxima linha a partir do início de linha pos (ou size no fim do buffer).
+ */
+inline std::size_t next_line(const char* data, std::size_t size, std::size_t pos) {
+    const char* nl = (const char*)std::memchr(data + pos, '\n', size - pos);
+    return nl ? (nl - data) + 1 : size;
+}
+
+/**
+ * @brief Linha que começa em pos (sem o '\n').
+ */
+inline LineRef line_at(const char* data, std::size_t size, std::size_t pos) {
+    const char* nl = (const char*)std::memchr(data + pos, '\n', size - pos);
+    return LineRef{data + pos, (nl ? (std::size_t)(nl - data) : size) - pos};
+}
+
+/**
+ * @brief Busca binária sobre as linhas ordenadas de um buffer, por deslocamento em bytes.
+ *
+ * Procura no intervalo [lo, hi), cujos extremos são inícios de linha, o início da primeira
+ * linha que não é menor que key (ou, com upper, que é maior que key). Cada passo volta do
+ * meio do intervalo até o início da linha que o contém.
+ *
+ * @param data Buffer com linhas ordenadas terminadas por '\n'.
+ * @param size Tamanho do buffer.
+ * @param lo Início do intervalo (início de linha).
+ * @param hi Fim do intervalo (início de linha ou size).
+ * @param key Chave procurada.
+ * @param upper Se true, equivale a upper_bound; senão, a lower_bound.
+ * @return Deslocamento do início da linha encontrada, ou hi.
+ */
+std::size_t search_lines(const char* data, std::size_t size, std::size_t lo, std::size_t hi,
+                         const LineRef& key, bool upper);
+
+} // namespace dnasort
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,174 @@
+/**
+ * @file Merge.cpp
+ * @brief Implementação da intercalação distribuída de arquivos já ordenados.
+ */
+
+#include "Merge.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+using namespace std;
+
+#define WRITE_CHUNK (4 << 20)
+
+namespace dnasort {
+
+/**
+ * @brief Cortes (início de linha em cada arquivo) da maior chave x cujas linhas menores somam
+ *        no máximo target bytes.
+ *
+ * Mantém em cada arquivo uma janela de linhas candidatas; a cada passo testa a linha do meio
+ * da maior janela e descarta a metade que não pode conter x.
+ */
+static vector<uint64_t> find_cuts(const vector<unique_ptr<MappedFile>>& files, uint64_t target) {
+    int k = files.size();
+    vector<size_t> lo(k, 0), hi(k), less_pos(k);
+    for (int i = 0; i < k; i++) hi[i] = files[i]->size();
+
+    LineRef best = {0, 0};
+    bool found = false;
+    while (true) {
+        int f = -1;
+        size_t widest = 0;
+        for (int i = 0; i < k; i++) {
+            if (hi[i] - lo[i] > widest) { widest = hi[i] - lo[i]; f = i; }
+        }
+        if (f < 0) break;
+
+        const char* data = files[f]->data();
+        size_t mid = lo[f] + (hi[f] - lo[f]) / 2;
+        const char* nl = (const char*)memrchr(data + lo[f], '\n', mid - lo[f]);
+        LineRef x = line_at(data, files[f]->size(), nl ? (nl - data) + 1 : lo[f]);
+
+        uint64_t less = 0;
+        for (int i = 0; i < k; i++) {
+            less_pos[i] = search_lines(files[i]->data(), files[i]->size(), 0, files[i]->size(), x, false);
+            less += less_pos[i];
+        }
+        if (less <= target) {
+            best = x;
+            found = true;
+            for (int i = 0; i < k; i++) {
+                size_t upper = search_lines(files[i]->data(), files[i]->size(), less_pos[i], files[i]->size(), x, true);
+                lo[i] = min(max(lo[i], upper), hi[i]);
+            }
+        } else {
+            for (int i = 0; i < k; i++) hi[i] = max(min(hi[i], less_pos[i]), lo[i]);
+        }
+    }
+
+    vector<uint64_t> cuts(k, 0);
+    if (found) {
+        for (int i = 0; i < k; i++) cuts[i] = search_lines(files[i]->data(), files[i]->size(), 0, files[i]->size(), best, false);
+    }
+    return cuts;
+}
+
+/**
+ * @brief Grava todo o buffer no deslocamento dado.
+ * @return false em caso de erro de escrita.
+ */
+static bool write_at(int fd, const vector<char>& buf, uint64_t offset) {
+    size_t done = 0;
+    while (done < buf.size()) {
+        ssize_t n = pwrite(fd, buf.data() + done, buf.size() - done, offset + done);
+        if (n <= 0) return false;
+        done += n;
+    }
+    return true;
+}
+
+void merge_sorted_files(Comm& comm, const vector<string>& inputs, const string& output, MergeStats* stats) {
+    int rank = comm.rank(), size = comm.size();
+    int k = inputs.size();
+
+    // Mapeamento das entradas; um erro em qualquer rank é reportado por todos
+    vector<unique_ptr<MappedFile>> files;
+    string error;
+    try {
+        for (const auto& name : inputs) files.emplace_back(new MappedFile(name));
+    } catch (const exception& e) {
+        error = e.what();
+    }
+    if (allreduce(comm, (uint64_t)!error.empty(), ReduceOp::MAX)) {
+        throw runtime_error(error.empty() ? "Erro ao abrir os arquivos de entrada" : error);
+    }
+
+    // Fronteira entre os ranks rank - 1 e rank
+    double splitters_start = comm.wtime();
+    uint64_t total = 0;
+    for (const auto& f : files) total += f->size();
+    vector<uint64_t> cut(k, 0);
+    if (rank > 0) cut = find_cuts(files, total * rank / size);
+    vector<uint64_t> cuts(k * size);
+    comm.allgather(cut.data(), k * sizeof(uint64_t), cuts.data());
+    double splitters_end = comm.wtime();
+
+    // Fatia local de cada arquivo e deslocamento da saída local
+    double merge_start = comm.wtime();
+    vector<size_t> pos(k), end(k);
+    uint64_t local_bytes = 0;
+    for (int i = 0; i < k; i++) {
+        pos[i] = cuts[rank * k + i];
+        end[i] = (rank + 1 < size) ? cuts[(rank + 1) * k + i] : files[i]->size();
+        local_bytes += end[i] - pos[i];
+        // Última linha sem '\n' recebe uma quebra de linha na saída
+        if (end[i] > pos[i] && files[i]->data()[end[i] - 1] != '\n') local_bytes++;
+    }
+    uint64_t offset = exscan(comm, local_bytes, ReduceOp::SUM);
+    uint64_t output_bytes = allreduce(comm, local_bytes, ReduceOp::SUM);
+
+    // O MASTER cria o arquivo com o tamanho final; os demais ranks o abrem em seguida
+    int fd = -1;
+    int created = 1;
+    if (rank == MASTER) {
+        fd = open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        created = (fd >= 0 && ftruncate(fd, output_bytes) == 0);
+    }
+    comm.bcast(&created, sizeof(created), MASTER);
+    if (!created) {
+        if (fd >= 0) close(fd);
+        throw runtime_error("Erro ao abrir o arquivo de saída: " + output);
+    }
+    if (rank != MASTER) fd = open(output.c_str(), O_WRONLY);
+
+    // Intercalação da fatia local com a árvore de perdedores
+    bool ok = (fd >= 0);
+    vector<LineRange> ranges(k);
+    for (int i = 0; i < k; i++) ranges[i] = LineRange{files[i]->data(), files[i]->size(), pos[i], end[i]};
+
+    vector<char> buf;
+    buf.reserve(WRITE_CHUNK);
+    uint64_t written = offset;
+    if (ok) {
+        merge_line_ranges(ranges, [&](const LineRef& line) {
+            buf.insert(buf.end(), line.data, line.data + line.len);
+            buf.push_back('\n');
+            if (ok && buf.size() >= WRITE_CHUNK) {
+                ok = write_at(fd, buf, written);
+                written += buf.size();
+                buf.clear();
+            }
+        });
+    }
+    if (ok) ok = write_at(fd, buf, written);
+    if (fd >= 0 && close(fd) != 0) ok = false;
+    if (allreduce(comm, (uint64_t)!ok, ReduceOp::MAX)) {
+        throw runtime_error("Erro ao gravar o arquivo de saída: " + output);
+    }
+    double merge_end = comm.wtime();
+
+    if (stats) {
+        stats->splitters = splitters_end - splitters_start;
+        stats->merge = merge_end - merge_start;
+        stats->bytes = output_bytes;
+    }
+}
+
+} // namespace dnasort
@@ -0,0 +1,87 @@
+/**
+ * @file Merge.h
+ * @brief Intercalação distribuída de arquivos já ordenados.
+ */
+
+#ifndef MERGE_H
+#define MERGE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Comm.h"
+#include "LoserTree.h"
+#include "MappedFile.h"
+
+namespace dnasort {
+
+/**
+ * @brief Intervalo [begin, end) de linhas ordenadas de um buffer (extremos em início de linha).
+ */
+struct LineRange {
+    const char* data;
+    std::size_t size;
+    std::size_t begin;
+    std::size_t end;
+};
+
+/**
+ * @brief Intercala intervalos de linhas ordenadas com uma árvore de perdedores.
+ *
+ * Linhas iguais são entregues na ordem dos intervalos.
+ *
+ * @param ranges Intervalos a intercalar.
+ * @param visit Chamada com cada linha (LineRef), em ordem crescente.
+ */
+template <typename Visit>
+void merge_line_ranges(const std::vector<LineRange>& ranges, Visit visit) {
+    int k = ranges.size();
+    std::vector<std::size_t> pos(k);
+    LoserTree<LineRef> tree(k);
+    for (int i = 0; i < k; i++) {
+        pos[i] = ranges[i].begin;
+        if (pos[i] < ranges[i].end) tree.set(i, line_at(ranges[i].data, ranges[i].size, pos[i]));
+    }
+    tree.build();
+
+    while (!tree.empty()) {
+        int i = tree.top();
+        visit(tree.top_key());
+        pos[i] = next_line(ranges[i].data, ranges[i].size, pos[i]);
+        if (pos[i] < ranges[i].end) tree.replace_top(line_at(ranges[i].data, ranges[i].size, pos[i]));
+        else tree.pop_top();
+    }
+}
+
+/**
+ * @brief Tempos e volume da intercalação distribuída.
+ */
+struct MergeStats {
+    double splitters = 0;  ///< Busca das fronteiras entre os ranks, em segundos.
+    double merge = 0;      ///< Intercalação e escrita da fatia local, em segundos.
+    uint64_t bytes = 0;    ///< Tamanho do arquivo de saída.
+};
+
+/**
+ * @brief Intercala arquivos de sequências já ordenados em um único arquivo ordenado.
+ *
+ * Os arquivos são mapeados em memória por todos os ranks. O rank r procura, com buscas
+ * binárias por deslocamento em bytes nos arquivos, a maior chave x tal que as linhas menores
+ * que x somam no máximo r / size dos bytes de entrada; os cortes de x em cada arquivo são a
+ * fronteira entre os ranks r - 1 e r, e as fronteiras são trocadas com allgather. Linhas iguais
+ * ficam sempre no mesmo rank. Cada rank intercala a sua fatia de todos os arquivos com uma
+ * árvore de perdedores e grava o resultado no deslocamento calculado com exscan, em paralelo
+ * com os demais ranks.
+ *
+ * @param comm Comunicador.
+ * @param inputs Arquivos de entrada, cada um com uma sequência por linha em ordem crescente.
+ * @param output Arquivo de saída.
+ * @param stats Se não nulo, recebe os tempos e o tamanho da saída.
+ */
+void merge_sorted_files(Comm& comm, const std::vector<std::string>& inputs, const std::string& output,
+                        MergeStats* stats = 0);
+
+} // namespace dnasort
+
+#endif // MERGE_H
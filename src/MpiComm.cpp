@@ -0,0 +1,280 @@
+/**
+ * @file MpiComm.cpp
+ * @brief Implementação de Comm sobre um comunicador MPI.
+ */
+
+#include "MpiComm.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+#ifndef MPI_CHUNK_BYTES
+#define MPI_CHUNK_BYTES (1 << 30) ///< Maior mensagem MPI; transferências maiores são divididas em partes.
+#endif
+#define CHUNKED_TAG 32000         ///< Tag das mensagens ponto a ponto de gatherv e alltoallv em partes.
+
+namespace dnasort {
+
+int to_mpi_count(size_t bytes) {
+    if (bytes > (size_t)INT_MAX) throw overflow_error("Mensagem MPI maior que INT_MAX bytes");
+    return (int)bytes;
+}
+
+/**
+ * @brief Contagens e deslocamentos em bytes no formato do MPI.
+ */
+static void to_mpi_counts(const size_t* bytes, int size, vector<int>& counts, vector<int>& displs) {
+    counts.resize(size);
+    displs.resize(size);
+    size_t offset = 0;
+    for (int p = 0; p < size; p++) {
+        counts[p] = to_mpi_count(bytes[p]);
+        displs[p] = to_mpi_count(offset);
+        offset += bytes[p];
+    }
+}
+
+static MPI_Datatype to_mpi_type(DataType type) {
+    switch (type) {
+        case DataType::INT64:  return MPI_LONG_LONG;
+        case DataType::UINT64: return MPI_UNSIGNED_LONG_LONG;
+        default:               return MPI_DOUBLE;
+    }
+}
+
+static MPI_Op to_mpi_op(ReduceOp op) {
+    switch (op) {
+        case ReduceOp::SUM: return MPI_SUM;
+        case ReduceOp::MAX: return MPI_MAX;
+        default:            return MPI_MIN;
+    }
+}
+
+MpiComm::MpiComm(MPI_Comm comm, bool owned) : comm_(comm), owned_(owned) {
+    MPI_Comm_rank(comm_, &rank_);
+    MPI_Comm_size(comm_, &size_);
+}
+
+MpiComm::~MpiComm() {
+    if (owned_) MPI_Comm_free(&comm_);
+}
+
+double MpiComm::wtime() const {
+    return MPI_Wtime();
+}
+
+void MpiComm::barrier() {
+    MPI_Barrier(comm_);
+}
+
+unique_ptr<Comm> MpiComm::split(int color, int key) {
+    MPI_Comm sub;
+    MPI_Comm_split(comm_, color, key, &sub);
+    return unique_ptr<Comm>(new MpiComm(sub, true));
+}
+
+/**
+ * @brief Tamanho da parte de uma transferência de bytes bytes que começa em offset.
+ */
+static int chunk_count(size_t bytes, size_t offset) {
+    return (int)min<size_t>(MPI_CHUNK_BYTES, bytes - offset);
+}
+
+// Mensagens maiores que MPI_CHUNK_BYTES seguem em partes com a mesma tag; o MPI entrega as
+// mensagens entre um par de processos com a mesma tag na ordem de envio.
+void MpiComm::send(const void* buf, size_t bytes, int dest, int tag) {
+    size_t offset = 0;
+    do {
+        int count = chunk_count(bytes, offset);
+        MPI_Send((const char*)buf + offset, count, MPI_BYTE, dest, tag, comm_);
+        offset += count;
+    } while (offset < bytes);
+}
+
+void MpiComm::recv(void* buf, size_t bytes, int source, int tag) {
+    size_t offset = 0;
+    do {
+        int count = chunk_count(bytes, offset);
+        MPI_Recv((char*)buf + offset, count, MPI_BYTE, source, tag, comm_, MPI_STATUS_IGNORE);
+        offset += count;
+    } while (offset < bytes);
+}
+
+void MpiComm::bcast(void* buf, size_t bytes, int root) {
+    size_t offset = 0;
+    do {
+        int count = chunk_count(bytes, offset);
+        MPI_Bcast((char*)buf + offset, count, MPI_BYTE, root, comm_);
+        offset += count;
+    } while (offset < bytes);
+}
+
+/**
+ * @brief Indica, em todos os ranks, se alguma contagem ou deslocamento local passa de MPI_CHUNK_BYTES.
+ */
+static bool any_large(MPI_Comm comm, size_t local_bytes) {
+    int local = local_bytes > (size_t)MPI_CHUNK_BYTES, global;
+    MPI_Allreduce(&local, &global, 1, MPI_INT, MPI_MAX, comm);
+    return global != 0;
+}
+
+/**
+ * @brief Inicia o envio (ou recebimento) de bytes bytes em partes de até MPI_CHUNK_BYTES.
+ */
+static void post_chunks(char* buf, size_t bytes, int peer, bool sending, MPI_Comm comm, vector<MPI_Request>& requests) {
+    for (size_t offset = 0; offset < bytes; ) {
+        int count = chunk_count(bytes, offset);
+        requests.push_back(MPI_REQUEST_NULL);
+        if (sending) MPI_Isend(buf + offset, count, MPI_BYTE, peer, CHUNKED_TAG, comm, &requests.back());
+        else MPI_Irecv(buf + offset, count, MPI_BYTE, peer, CHUNKED_TAG, comm, &requests.back());
+        offset += count;
+    }
+}
+
+void MpiComm::gather(const void* send, size_t bytes, void* recv, int root) {
+    int count = to_mpi_count(bytes);
+    MPI_Gather(send, count, MPI_BYTE, recv, count, MPI_BYTE, root, comm_);
+}
+
+void MpiComm::gatherv(const void* send, size_t bytes, void* recv, const size_t* recv_bytes, int root) {
+    size_t total = bytes;
+    if (rank_ == root) for (int p = 0; p < size_; p++) total += recv_bytes[p];
+    if (any_large(comm_, total)) {
+        // Contagens ou deslocamentos além do int do MPI: mensagens ponto a ponto em partes
+        vector<MPI_Request> requests;
+        if (rank_ == root) {
+            size_t offset = 0;
+            for (int p = 0; p < size_; p++) {
+                if (p == root) memcpy((char*)recv + offset, send, bytes);
+                else post_chunks((char*)recv + offset, recv_bytes[p], p, false, comm_, requests);
+                offset += recv_bytes[p];
+            }
+        } else {
+            post_chunks((char*)send, bytes, root, true, comm_, requests);
+        }
+        MPI_Waitall((int)requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+        return;
+    }
+
+    vector<int> counts, displs;
+    if (rank_ == root) to_mpi_counts(recv_bytes, size_, counts, displs);
+    MPI_Gatherv(send, to_mpi_count(bytes), MPI_BYTE, recv, counts.data(), displs.data(), MPI_BYTE, root, comm_);
+}
+
+void MpiComm::allgather(const void* send, size_t bytes, void* recv) {
+    int count = to_mpi_count(bytes);
+    MPI_Allgather(send, count, MPI_BYTE, recv, count, MPI_BYTE, comm_);
+}
+
+void MpiComm::alltoall(const void* send, size_t bytes, void* recv) {
+    int count = to_mpi_count(bytes);
+    MPI_Alltoall(send, count, MPI_BYTE, recv, count, MPI_BYTE, comm_);
+}
+
+void MpiComm::alltoallv(const void* send, const size_t* send_bytes, void* recv, const size_t* recv_bytes) {
+    size_t send_total = 0, recv_total = 0;
+    for (int p = 0; p < size_; p++) {
+        send_total += send_bytes[p];
+        recv_total += recv_bytes[p];
+    }
+    if (any_large(comm_, max(send_total, recv_total))) {
+        // Contagens ou deslocamentos além do int do MPI: mensagens ponto a ponto em partes
+        vector<MPI_Request> requests;
+        size_t send_offset = 0, recv_offset = 0;
+        for (int p = 0; p < size_; p++) {
+            if (p == rank_) {
+                memcpy((char*)recv + recv_offset, (const char*)send + send_offset, send_bytes[p]);
+            } else {
+                post_chunks((char*)recv + recv_offset, recv_bytes[p], p, false, comm_, requests);
+                post_chunks((char*)send + send_offset, send_bytes[p], p, true, comm_, requests);
+            }
+            send_offset += send_bytes[p];
+            recv_offset += recv_bytes[p];
+        }
+        MPI_Waitall((int)requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+        return;
+    }
+
+    vector<int> send_counts, send_displs, recv_counts, recv_displs;
+    to_mpi_counts(send_bytes, size_, send_counts, send_displs);
+    to_mpi_counts(recv_bytes, size_, recv_counts, recv_displs);
+    MPI_Alltoallv(send, send_counts.data(), send_displs.data(), MPI_BYTE,
+                  recv, recv_counts.data(), recv_displs.data(), MPI_BYTE, comm_);
+}
+
+void MpiComm::allreduce(const void* in, void* out, int count, DataType type, ReduceOp op) {
+    MPI_Allreduce(in, out, count, to_mpi_type(type), to_mpi_op(op), comm_);
+}
+
+void MpiComm::exscan(const void* in, void* out, int count, DataType type, ReduceOp op) {
+    MPI_Exscan(in, out, count, to_mpi_type(type), to_mpi_op(op), comm_);
+    if (rank_ == 0) memset(out, 0, count * 8);
+}
+
+void MpiComm::send_strings(vector<string>& data, int dest, int tag) {
+    vector<char> buf = pack_strings(data);
+    uint64_t bytes = buf.size();
+    MPI_Send(&bytes, 1, MPI_UINT64_T, dest, tag, comm_);
+    send(buf.data(), bytes, dest, tag + 1);
+}
+
+vector<string> MpiComm::recv_strings(int source, int tag) {
+    uint64_t bytes;
+    MPI_Recv(&bytes, 1, MPI_UINT64_T, source, tag, comm_, MPI_STATUS_IGNORE);
+    vector<char> buf(bytes);
+    recv(buf.data(), bytes, source, tag + 1);
+    return unpack_strings(buf.data(), bytes);
+}
+
+vector<string> MpiComm::gather_strings(vector<string>& local, int root) {
+    vector<string> gathered;
+    if (rank_ == root) {
+        for (int p = 0; p < size_; p++) {
+            if (p == root) {
+                for (auto& seq : local) gathered.push_back(move(seq));
+                continue;
+            }
+            vector<string> part = recv_strings(p, 2);
+            for (auto& seq : part) gathered.push_back(move(seq));
+        }
+    } else {
+        send_strings(local, root, 2);
+    }
+    vector<string>().swap(local);
+    return gathered;
+}
+
+void MpiComm::bcast_strings(vector<string>& data, int root) {
+    vector<char> buf;
+    if (rank_ == root) buf = pack_strings(data);
+    uint64_t bytes = buf.size();
+    MPI_Bcast(&bytes, 1, MPI_UINT64_T, root, comm_);
+    buf.resize(bytes);
+    bcast(buf.data(), bytes, root);
+    if (rank_ != root) data = unpack_strings(buf.data(), bytes);
+}
+
+vector<string> MpiComm::alltoallv_strings(vector<string>& send, const vector<size_t>& send_counts) {
+    // Tamanho empacotado de cada bucket
+    vector<size_t> send_bytes(size_, 0), recv_bytes(size_);
+    size_t begin = 0;
+    for (int p = 0; p < size_; p++) {
+        for (size_t i = begin; i < begin + send_counts[p]; i++) send_bytes[p] += send[i].size() + 1;
+        begin += send_counts[p];
+    }
+    vector<char> send_buf = pack_strings(send);
+    vector<string>().swap(send);
+    alltoall(send_bytes.data(), sizeof(size_t), recv_bytes.data());
+
+    size_t total = 0;
+    for (int p = 0; p < size_; p++) total += recv_bytes[p];
+    vector<char> recv_buf(total);
+    alltoallv(send_buf.data(), send_bytes.data(), recv_buf.data(), recv_bytes.data());
+    return unpack_strings(recv_buf.data(), total);
+}
+
+} // namespace dnasort
@@ -0,0 +1,78 @@
+/**
+ * @file MpiComm.h
+ * @brief Implementação de Comm sobre um comunicador MPI.
+ */
+
+#ifndef MPI_COMM_H
+#define MPI_COMM_H
+
+#include <mpi.h>
+
+#include "Comm.h"
+
+namespace dnasort {
+
+/**
+ * @brief Comm em que cada rank é um processo MPI.
+ *
+ * As sequências são empacotadas com pack_strings e enviadas em uma única mensagem por destino.
+ * Transferências maiores que MPI_CHUNK_BYTES (1 GiB) seguem em partes, de modo que leituras
+ * longas não esbarram no limite de INT_MAX bytes das contagens do MPI; gatherv e alltoallv
+ * passam então a mensagens ponto a ponto não bloqueantes, decididas em conjunto por todos os ranks.
+ */
+class MpiComm : public Comm {
+public:
+    /**
+     * @param comm Comunicador MPI.
+     * @param owned Se true, comm é liberado com MPI_Comm_free no destrutor.
+     */
+    explicit MpiComm(MPI_Comm comm, bool owned = false);
+    ~MpiComm();
+
+    MPI_Comm mpi_comm() const { return comm_; }
+
+    int rank() const override { return rank_; }
+    int size() const override { return size_; }
+    double wtime() const override;
+    void barrier() override;
+    std::unique_ptr<Comm> split(int color, int key) override;
+
+    void send(const void* buf, std::size_t bytes, int dest, int tag) override;
+    void recv(void* buf, std::size_t bytes, int source, int tag) override;
+    void bcast(void* buf, std::size_t bytes, int root) override;
+    void gather(const void* send, std::size_t bytes, void* recv, int root) override;
+    void gatherv(const void* send, std::size_t bytes, void* recv, const std::size_t* recv_bytes, int root) override;
+    void allgather(const void* send, std::size_t bytes, void* recv) override;
+    void alltoall(const void* send, std::size_t bytes, void* recv) override;
+    void alltoallv(const void* send, const std::size_t* send_bytes,
+                   void* recv, const std::size_t* recv_bytes) override;
+    void allreduce(const void* in, void* out, int count, DataType type, ReduceOp op) override;
+    void exscan(const void* in, void* out, int count, DataType type, ReduceOp op) override;
+
+    void send_strings(std::vector<std::string>& data, int dest, int tag) override;
+    std::vector<std::string> recv_strings(int source, int tag) override;
+    std::vector<std::string> gather_strings(std::vector<std::string>& local, int root) override;
+    void bcast_strings(std::vector<std::string>& data, int root) override;
+    std::vector<std::string> alltoallv_strings(std::vector<std::string>& send,
+                                               const std::vector<std::size_t>& send_counts) override;
+
+private:
+    MpiComm(const MpiComm&);
+    MpiComm& operator=(const MpiComm&);
+
+    MPI_Comm comm_;
+    bool owned_;
+    int rank_;
+    int size_;
+};
+
+/**
+ * @brief Converte uma quantidade de bytes para o tipo int usado nas contagens do MPI.
+ * @param bytes Quantidade de bytes.
+ * @return A mesma quantidade como int.
+ */
+int to_mpi_count(std::size_t bytes);
+
+} // namespace dnasort
+
+#endif // MPI_COMM_H
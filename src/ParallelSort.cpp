@@ -0,0 +1,419 @@
+/**
+ * @file ParallelSort.cpp
+ * @brief Implementação da parte distribuída da biblioteca de ordenação de sequências de DNA.
+ */
+
+#include "ParallelSort.h"
+#include "Progress.h"
+
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+namespace dnasort {
+
+/**
+ * @brief Tamanho da faixa de cada rank em sorted_local (upper_bound nos pivôs com a ordem less).
+ */
+template <typename Less>
+static vector<size_t> bucket_sizes(const vector<string>& sorted_local, const vector<string>& pivots, int size, Less less) {
+    vector<size_t> counts(size);
+    size_t begin = 0;
+    for (int p = 0; p < size; p++) {
+        size_t end = (p < size - 1)
+            ? upper_bound(sorted_local.begin() + begin, sorted_local.end(), pivots[p], less) - sorted_local.begin()
+            : sorted_local.size();
+        counts[p] = end - begin;
+        begin = end;
+    }
+    return counts;
+}
+
+/**
+ * @brief bucket_sizes na ordem de opts (por campo ou lexicográfica).
+ */
+static vector<size_t> bucket_sizes(const vector<string>& sorted_local, const vector<string>& pivots, int size,
+                                   const SortOptions& opts) {
+    if (opts.key_field > 0) return bucket_sizes(sorted_local, pivots, size, RecordLess(opts));
+    return bucket_sizes(sorted_local, pivots, size, less<string>());
+}
+
+vector<string> exchange_strings(Comm& comm, vector<string>& sorted_local, const vector<string>& pivots,
+                                const SortOptions& opts) {
+    vector<size_t> send_counts = bucket_sizes(sorted_local, pivots, comm.size(), opts);
+    return comm.alltoallv_strings(sorted_local, send_counts);
+}
+
+double bucket_imbalance(Comm& comm, const vector<string>& sorted_local, const vector<string>& pivots,
+                        const SortOptions& opts) {
+    int size = comm.size();
+    vector<size_t> sizes = bucket_sizes(sorted_local, pivots, size, opts);
+    vector<uint64_t> counts(sizes.begin(), sizes.end()), totals(size);
+    allreduce(comm, counts.data(), totals.data(), size, ReduceOp::SUM);
+
+    uint64_t total = 0, largest = 0;
+    for (uint64_t t : totals) {
+        total += t;
+        largest = max(largest, t);
+    }
+    return total > 0 ? (double)largest * size / total : 1.0;
+}
+
+void write_splitters(const string& filename, const vector<string>& pivots) {
+    ofstream file(filename);
+    if (!file.is_open()) {throw runtime_error("Erro ao abrir o arquivo de saída: " + filename);}
+
+    file << "SPLITTERS 1\n";
+    for (const auto& pivot : pivots) file << "splitter " << pivot << "\n";
+    file.close();
+}
+
+vector<string> read_splitters(const string& filename) {
+    ifstream file(filename);
+    if (!file.is_open()) {throw runtime_error("Erro ao abrir o arquivo de entrada: " + filename);}
+
+    vector<string> pivots;
+    string line;
+    while (getline(file, line)) {
+        if (line.compare(0, 9, "splitter ") == 0) pivots.push_back(line.substr(9));
+    }
+    return pivots;
+}
+
+vector<string> distribute_sequences(Comm& comm, vector<string>& all_data, int n) {
+    int rank = comm.rank(), size = comm.size();
+    if (rank != MASTER) return comm.recv_strings(MASTER, 0);
+
+    vector<string> local_data;
+    int offset = 0;
+    for (int p = 0; p < size; p++) {
+        int count = n / size + (p < (n % size) ? 1 : 0);
+        vector<string> part(make_move_iterator(all_data.begin() + offset),
+                            make_move_iterator(all_data.begin() + offset + count));
+        if (p == MASTER) local_data.swap(part);
+        else comm.send_strings(part, p, 0);
+        offset += count;
+    }
+    vector<string>().swap(all_data);
+    return local_data;
+}
+
+/**
+ * @brief Sample Sort pelas primeiras opts.key_prefix bases (sort com SortOptions::key_prefix).
+ *
+ * As amostras e os pivôs são as chaves inteiras de prefixo (8 bytes cada, em vez de sequências
+ * inteiras) e as faixas são delimitadas por upper_bound nessas chaves. As ordenações locais são
+ * radix sorts estáveis (sort_by_prefix); como a troca mantém a ordem dos ranks de origem, os
+ * empates saem na ordem da entrada distribuída.
+ */
+static vector<string> sort_prefix(Comm& comm, vector<string>& local, const SortOptions& opts, SortStats* stats) {
+    int size = comm.size();
+    to_sort_keys(local, opts);
+
+    progress_phase("ordenação local");
+    double local_sort_start = comm.wtime();
+    vector<uint64_t> prefixes = sort_by_prefix(local, opts);
+    double local_sort_end = comm.wtime();
+    progress_advance(local);
+
+    progress_phase("amostragem");
+    vector<uint64_t> pivots = sample_pivots(comm, prefixes);
+
+    progress_phase("troca");
+    vector<size_t> send_counts(size);
+    size_t begin = 0;
+    for (int p = 0; p < size; p++) {
+        size_t end = (p < size - 1)
+            ? upper_bound(prefixes.begin() + begin, prefixes.end(), pivots[p]) - prefixes.begin()
+            : prefixes.size();
+        send_counts[p] = end - begin;
+        begin = end;
+    }
+    vector<uint64_t>().swap(prefixes);
+    vector<string> new_local = comm.alltoallv_strings(local, send_counts);
+    vector<string>().swap(local);
+    progress_advance(new_local);
+
+    progress_phase("ordenação final");
+    double final_sort_start = comm.wtime();
+    sort_by_prefix(new_local, opts);
+    double final_sort_end = comm.wtime();
+    progress_advance(new_local);
+
+    from_sort_keys(new_local, opts);
+
+    if (stats) {
+        stats->local_sort = local_sort_end - local_sort_start;
+        stats->final_sort = final_sort_end - final_sort_start;
+        stats->pivots.clear();
+        stats->reused_pivots = false;
+        stats->hint_imbalance = 0;
+    }
+    return new_local;
+}
+
+vector<string> sort(Comm& comm, vector<string>& local, const SortOptions& opts, SortStats* stats,
+                    const PivotHint* hint, SortCheckpoint* checkpoint) {
+    if (opts.key_prefix > 0) return sort_prefix(comm, local, opts, stats);
+
+    int rank = comm.rank(), size = comm.size();
+    CheckpointPhase resumed = checkpoint ? checkpoint->resumed() : CheckpointPhase::NONE;
+
+    double local_sort_start = comm.wtime(), local_sort_end = local_sort_start;
+    double final_sort_start = local_sort_start, final_sort_end = local_sort_start;
+    vector<string> pivots, new_local;
+    double hint_imbalance = 0;
+    bool reused = false;
+
+    if (resumed == CheckpointPhase::EXCHANGE) {
+        // Partição final e pivôs já salvos
+        new_local = checkpoint->load(CheckpointPhase::EXCHANGE, &pivots);
+        vector<string>().swap(local);
+    } else {
+        if (resumed == CheckpointPhase::LOCAL_SORT) {
+            // Run ordenada já salva (em chaves de ordenação, se for o caso)
+            local = checkpoint->load(CheckpointPhase::LOCAL_SORT);
+        } else {
+            // Conversão para as chaves de ordenação (canônicas e da colação), uma única vez por sequência
+            to_sort_keys(local, opts);
+
+            // Ordenação local
+            progress_phase("ordenação local");
+            local_sort_start = comm.wtime();
+            sort_keys(local, opts);
+            local_sort_end = comm.wtime();
+            progress_advance(local);
+            if (checkpoint) checkpoint->save(CheckpointPhase::LOCAL_SORT, local);
+        }
+
+        // Pivôs dados, se mantêm as faixas equilibradas
+        bool hint_sorted = hint && (opts.key_field > 0 ? is_sorted(hint->pivots.begin(), hint->pivots.end(), RecordLess(opts))
+                                                       : is_sorted(hint->pivots.begin(), hint->pivots.end()));
+        if (hint && (int)hint->pivots.size() == size - 1 && hint_sorted) {
+            hint_imbalance = bucket_imbalance(comm, local, hint->pivots, opts);
+            if (hint_imbalance <= hint->max_imbalance) pivots = hint->pivots;
+        }
+        reused = (size == 1 || !pivots.empty());
+
+        if (!reused) {
+            progress_phase("amostragem");
+
+            // Seleção e coleta das amostras locais
+            vector<string> samples = select_samples(local, size - 1);
+            vector<string> gathered_samples = comm.gather_strings(samples, MASTER);
+
+            // Escolha dos pivôs globais e broadcast
+            pivots.resize(size - 1);
+            if (rank == MASTER) {
+                pivots = (opts.key_field > 0) ? choose_pivots(gathered_samples, size, RecordLess(opts))
+                                              : choose_pivots(gathered_samples, size);
+            }
+            comm.bcast_strings(pivots, MASTER);
+        }
+
+        // Troca de dados entre processos
+        progress_phase("troca");
+        new_local = exchange_strings(comm, local, pivots, opts);
+        vector<string>().swap(local);
+        progress_advance(new_local);
+
+        // Ordenação final local
+        progress_phase("ordenação final");
+        final_sort_start = comm.wtime();
+        sort_keys(new_local, opts);
+        final_sort_end = comm.wtime();
+        progress_advance(new_local);
+        if (checkpoint) checkpoint->save(CheckpointPhase::EXCHANGE, new_local, pivots);
+    }
+
+    from_sort_keys(new_local, opts);
+
+    if (stats) {
+        stats->local_sort = local_sort_end - local_sort_start;
+        stats->final_sort = final_sort_end - final_sort_start;
+        stats->pivots.swap(pivots);
+        stats->reused_pivots = reused && hint;
+        stats->hint_imbalance = hint_imbalance;
+    }
+    return new_local;
+}
+
+/**
+ * @brief Mantém em data apenas as K menores (ou maiores) sequências, em ordem crescente.
+ *
+ * Usa nth_element para separar as K candidatas em O(n) e ordena somente elas,
+ * evitando a ordenação completa da partição local.
+ *
+ * @param data Vetor de sequências; é reduzido para no máximo K elementos.
+ * @param k Quantidade de sequências a manter.
+ * @param bottom Se true, mantém as K maiores.
+ */
+static void select_local_k(vector<string>& data, int k, bool bottom) {
+    if ((int)data.size() > k) {
+        if (bottom) {
+            nth_element(data.begin(), data.end() - k, data.end());
+            data.erase(data.begin(), data.end() - k);
+        } else {
+            nth_element(data.begin(), data.begin() + k, data.end());
+            data.resize(k);
+        }
+    }
+    sequential_sort(data);
+}
+
+/**
+ * @brief Intercala duas listas ordenadas de candidatas mantendo apenas K.
+ * @param a Primeira lista ordenada; recebe o resultado.
+ * @param b Segunda lista ordenada.
+ * @param k Quantidade de sequências a manter.
+ * @param bottom Se true, mantém as K maiores.
+ */
+static void merge_candidates(vector<string>& a, const vector<string>& b, int k, bool bottom) {
+    vector<string> merged(a.size() + b.size());
+    merge(a.begin(), a.end(), b.begin(), b.end(), merged.begin());
+    if ((int)merged.size() > k) {
+        if (bottom) merged.erase(merged.begin(), merged.end() - k);
+        else merged.resize(k);
+    }
+    a.swap(merged);
+}
+
+vector<string> select_top_k(Comm& comm, vector<string>& local, int k, bool bottom, const SortOptions& opts) {
+    int rank = comm.rank(), size = comm.size();
+
+    to_sort_keys(local, opts);
+    select_local_k(local, k, bottom);
+
+    for (int step = 1; step < size; step *= 2) {
+        if (rank % (2 * step) == 0) {
+            int partner = rank + step;
+            if (partner < size) {
+                vector<string> other = comm.recv_strings(partner, 9);
+                merge_candidates(local, other, k, bottom);
+            }
+        } else {
+            comm.send_strings(local, rank - step, 9);
+            local.clear();
+            break;
+        }
+    }
+
+    from_sort_keys(local, opts);
+    return local;
+}
+
+/**
+ * Parte das partições locais ordenadas (primeira fase do Sample Sort) e mantém, para cada
+ * consulta, uma janela [lo, hi) em cada processo. A cada rodada cada processo envia como amostra
+ * a mediana da sua janela; o MASTER escolhe como pivô a mediana ponderada pelo tamanho das
+ * janelas e o difunde. O histograma local (elementos menores e menores ou iguais ao pivô) é
+ * somado com allreduce e a janela é reduzida para o lado que contém a posição procurada.
+ * Cada rodada descarta ao menos um quarto dos candidatos, logo são O(log n) rodadas, todas as
+ * consultas avançam juntas e nenhuma sequência é redistribuída.
+ */
+vector<string> select_ranks(Comm& comm, vector<string>& local, const vector<long long>& targets,
+                            const SortOptions& opts, SortStats* stats) {
+    int rank = comm.rank(), size = comm.size();
+
+    to_sort_keys(local, opts);
+
+    // Ordenação local
+    double local_sort_start = comm.wtime();
+    sequential_sort(local);
+    double local_sort_end = comm.wtime();
+    const vector<string>& sorted_local = local;
+
+    int m = targets.size();
+    vector<long long> k(targets);
+    vector<long long> lo(m, 0), hi(m, sorted_local.size());
+    vector<string> result(m);
+    vector<int> active(m);
+    iota(active.begin(), active.end(), 0);
+
+    int rounds = 0;
+    while (!active.empty()) {
+        rounds++;
+        int a_n = active.size();
+
+        // Amostras: mediana da janela local de cada consulta ativa
+        vector<string> samples(a_n);
+        vector<long long> weights(a_n);
+        for (int a = 0; a < a_n; a++) {
+            int j = active[a];
+            weights[a] = hi[j] - lo[j];
+            if (weights[a] > 0) samples[a] = sorted_local[lo[j] + weights[a] / 2];
+        }
+
+        vector<string> gathered = comm.gather_strings(samples, MASTER);
+        vector<long long> all_weights(rank == MASTER ? a_n * size : 0);
+        comm.gather(weights.data(), a_n * sizeof(long long), all_weights.data(), MASTER);
+
+        // Pivô de cada consulta: mediana ponderada das amostras
+        vector<string> pivots(a_n);
+        if (rank == MASTER) {
+            for (int a = 0; a < a_n; a++) {
+                vector<pair<string, long long>> candidates;
+                long long total = 0;
+                for (int p = 0; p < size; p++) {
+                    long long w = all_weights[p * a_n + a];
+                    if (w > 0) {
+                        candidates.emplace_back(gathered[p * a_n + a], w);
+                        total += w;
+                    }
+                }
+                std::sort(candidates.begin(), candidates.end());
+                long long acc = 0;
+                for (const auto& c : candidates) {
+                    acc += c.second;
+                    if (2 * acc >= total) { pivots[a] = c.first; break; }
+                }
+            }
+        }
+        comm.bcast_strings(pivots, MASTER);
+
+        // Histograma local em relação aos pivôs
+        vector<long long> less_pos(a_n), le_pos(a_n);
+        vector<long long> counts(2 * a_n), totals(2 * a_n);
+        for (int a = 0; a < a_n; a++) {
+            int j = active[a];
+            auto first = sorted_local.begin() + lo[j];
+            auto last = sorted_local.begin() + hi[j];
+            less_pos[a] = lower_bound(first, last, pivots[a]) - sorted_local.begin();
+            le_pos[a] = upper_bound(first, last, pivots[a]) - sorted_local.begin();
+            counts[2 * a] = less_pos[a] - lo[j];
+            counts[2 * a + 1] = le_pos[a] - lo[j];
+        }
+        allreduce(comm, counts.data(), totals.data(), 2 * a_n, ReduceOp::SUM);
+
+        // Redução das janelas
+        vector<int> still_active;
+        for (int a = 0; a < a_n; a++) {
+            int j = active[a];
+            if (k[j] < totals[2 * a]) {
+                hi[j] = less_pos[a];
+                still_active.push_back(j);
+            } else if (k[j] < totals[2 * a + 1]) {
+                result[j] = pivots[a];
+            } else {
+                k[j] -= totals[2 * a + 1];
+                lo[j] = le_pos[a];
+                still_active.push_back(j);
+            }
+        }
+        active.swap(still_active);
+    }
+
+    from_sort_keys(result, opts);
+
+    if (stats) {
+        stats->local_sort = local_sort_end - local_sort_start;
+        stats->rounds = rounds;
+    }
+    return result;
+}
+
+} // namespace dnasort
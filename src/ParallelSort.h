@@ -0,0 +1,237 @@
+/**
+ * @file ParallelSort.h
+ * @brief Parte distribuída da biblioteca de ordenação de sequências de DNA.
+ *
+ * Contém o Sample Sort em memória, os modos de seleção distribuída e as primitivas do
+ * algoritmo (amostragem, escolha de pivôs e troca por faixas) reutilizadas pelos demais módulos
+ * distribuídos. A comunicação passa por Comm, com processos MPI (MpiComm) ou threads (ThreadComm).
+ *
+ * Exemplo de uso:
+ *   dnasort::MpiComm comm(MPI_COMM_WORLD);
+ *   std::vector<std::string> local = ...;  // partição qualquer dos dados em cada processo
+ *   std::vector<std::string> part = dnasort::sort(comm, local, dnasort::SortOptions());
+ *   // part: partição ordenada local; as partições estão em ordem crescente de rank.
+ */
+
+#ifndef PARALLEL_SORT_H
+#define PARALLEL_SORT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Checkpoint.h"
+#include "Comm.h"
+#include "DnaSort.h"
+
+namespace dnasort {
+
+/**
+ * @brief Tempos, contadores e pivôs registrados pelas funções distribuídas.
+ */
+struct SortStats {
+    double local_sort = 0;  ///< Tempo da ordenação local, em segundos.
+    double final_sort = 0;  ///< Tempo da ordenação final após a troca, em segundos.
+    int rounds = 0;         ///< Rodadas executadas por select_ranks.
+    std::vector<std::string> pivots; ///< Pivôs globais usados por sort (size - 1).
+    bool reused_pivots = false;      ///< sort usou os pivôs de PivotHint em vez de amostrar.
+    double hint_imbalance = 0;       ///< Desequilíbrio medido dos pivôs de PivotHint (0 sem PivotHint válido).
+};
+
+/**
+ * @brief Pivôs de uma execução anterior oferecidos a sort (devem ser iguais em todos os ranks).
+ */
+struct PivotHint {
+    std::vector<std::string> pivots;  ///< Pivôs em ordem crescente; usados apenas se forem size - 1.
+    double max_imbalance = 1.5;       ///< Maior desequilíbrio (bucket_imbalance) aceito antes de amostrar de novo.
+};
+
+/**
+ * @brief Ordenação distribuída (Sample Sort) de dados já em memória.
+ *
+ * Cada processo ordena sua partição, envia size - 1 amostras ao MASTER, que escolhe os pivôs
+ * globais e os difunde; as partições são trocadas por faixas e ordenadas novamente. Com hint,
+ * os pivôs dados substituem a amostragem se o desequilíbrio das faixas que produzem (medido
+ * com uma única redução das contagens) não passar de hint->max_imbalance. Com checkpoint, a run
+ * ordenada e a partição final são salvas, e as fases já salvas (checkpoint->resumed()) são puladas.
+ * Com opts.key_prefix, a ordem é a das primeiras bases, as amostras e os pivôs são as chaves
+ * inteiras de sort_by_prefix e hint e checkpoint não são usados (stats->pivots fica vazio).
+ *
+ * @param comm Comunicador dos processos participantes.
+ * @param local Partição local de entrada (é esvaziada).
+ * @param opts Opções de ordenação.
+ * @param stats Se não nulo, recebe os tempos das fases e os pivôs usados.
+ * @param hint Se não nulo, pivôs candidatos de uma execução anterior.
+ * @param checkpoint Se não nulo, checkpoints das fases (Checkpoint.h).
+ * @return Partição ordenada local; as partições estão em ordem crescente de rank.
+ */
+std::vector<std::string> sort(Comm& comm, std::vector<std::string>& local,
+                              const SortOptions& opts = SortOptions(), SortStats* stats = 0,
+                              const PivotHint* hint = 0, SortCheckpoint* checkpoint = 0);
+
+/**
+ * @brief Seleção distribuída das K menores (ou maiores) sequências.
+ *
+ * Cada processo seleciona localmente suas K candidatas com nth_element e um torneio em
+ * árvore binária reduz as candidatas até o MASTER em log2(P) rodadas; apenas no máximo
+ * K sequências saem de cada processo.
+ *
+ * @param comm Comunicador dos processos participantes.
+ * @param local Partição local (é modificada).
+ * @param k Quantidade de sequências a selecionar.
+ * @param bottom Se true, seleciona as K maiores.
+ * @param opts Opções de ordenação.
+ * @return No MASTER, as K sequências globais em ordem crescente; vazio nos demais.
+ */
+std::vector<std::string> select_top_k(Comm& comm, std::vector<std::string>& local, int k, bool bottom,
+                                      const SortOptions& opts = SortOptions());
+
+/**
+ * @brief Seleção múltipla distribuída das sequências em posições globais da ordem final.
+ * @param comm Comunicador dos processos participantes.
+ * @param local Partição local (é ordenada).
+ * @param targets Posições globais (base 0) procuradas.
+ * @param opts Opções de ordenação.
+ * @param stats Se não nulo, recebe o tempo da ordenação local e o número de rodadas.
+ * @return Sequência em cada posição pedida (em todos os processos).
+ */
+std::vector<std::string> select_ranks(Comm& comm, std::vector<std::string>& local,
+                                      const std::vector<long long>& targets,
+                                      const SortOptions& opts = SortOptions(), SortStats* stats = 0);
+
+/**
+ * @brief Distribui as sequências lidas pelo MASTER em blocos contíguos entre os processos.
+ * @param comm Comunicador dos processos participantes.
+ * @param all_data Todas as sequências (relevante apenas no MASTER; é esvaziado).
+ * @param n Número total de sequências (conhecido por todos os processos).
+ * @return Partição local de sequências.
+ */
+std::vector<std::string> distribute_sequences(Comm& comm, std::vector<std::string>& all_data, int n);
+
+/**
+ * @brief Troca por faixas de uma partição local de sequências já ordenada.
+ *
+ * O bucket de cada rank é um intervalo contíguo delimitado por upper_bound nos pivôs;
+ * todos os buckets seguem em uma única chamada a Comm::alltoallv_strings.
+ *
+ * @param comm Comunicador.
+ * @param sorted_local Partição local ordenada (é esvaziada).
+ * @param pivots Pivôs globais (size - 1).
+ * @param opts Ordem das sequências (campo-chave com opts.key_field; lexicográfica por padrão).
+ * @return Sequências recebidas, em ordem de rank de origem.
+ */
+std::vector<std::string> exchange_strings(Comm& comm, std::vector<std::string>& sorted_local,
+                                          const std::vector<std::string>& pivots,
+                                          const SortOptions& opts = SortOptions());
+
+/**
+ * @brief Desequilíbrio das faixas definidas por pivôs: maior faixa global / tamanho médio.
+ * @param comm Comunicador.
+ * @param sorted_local Partição local ordenada.
+ * @param pivots Pivôs globais (size - 1).
+ * @param opts Ordem das sequências, como em exchange_strings.
+ * @return 1 para faixas iguais (e para dados vazios); size se tudo cai em uma faixa.
+ */
+double bucket_imbalance(Comm& comm, const std::vector<std::string>& sorted_local,
+                        const std::vector<std::string>& pivots, const SortOptions& opts = SortOptions());
+
+/**
+ * @brief Grava pivôs em arquivo texto: "SPLITTERS 1" seguido de uma linha "splitter <pivô>" por pivô.
+ * @param filename Nome do arquivo.
+ * @param pivots Pivôs em ordem crescente.
+ */
+void write_splitters(const std::string& filename, const std::vector<std::string>& pivots);
+
+/**
+ * @brief Lê os pivôs das linhas "splitter <pivô>" de um arquivo gravado por write_splitters
+ *        ou de um manifesto de faixas (Shards.h).
+ * @param filename Nome do arquivo.
+ * @return Pivôs, na ordem do arquivo.
+ */
+std::vector<std::string> read_splitters(const std::string& filename);
+
+/**
+ * @brief Seleciona s amostras igualmente espaçadas de uma partição local ordenada.
+ * @param sorted_local Partição local ordenada.
+ * @param s Quantidade de amostras.
+ * @return Amostras locais.
+ */
+template <typename T>
+std::vector<T> select_samples(const std::vector<T>& sorted_local, int s) {
+    std::vector<T> samples;
+    for (int i = 1; i <= s; i++) {
+        std::size_t idx = i * sorted_local.size() / (s + 1);
+        if (idx < sorted_local.size())
+            samples.push_back(sorted_local[idx]);
+    }
+    return samples;
+}
+
+/**
+ * @brief Escolhe os size - 1 pivôs globais a partir das amostras reunidas no MASTER.
+ * @param gathered_samples Amostras de todos os processos (é ordenado).
+ * @param size Número de processos.
+ * @param less Ordem das amostras (padrão: operator<).
+ * @return Pivôs globais em ordem crescente.
+ */
+template <typename T, typename Less = std::less<T>>
+std::vector<T> choose_pivots(std::vector<T>& gathered_samples, int size, Less less = Less()) {
+    std::vector<T> pivots(size - 1);
+    if (gathered_samples.empty()) return pivots;
+    std::sort(gathered_samples.begin(), gathered_samples.end(), less);
+    for (int i = 1; i < size; i++) {
+        pivots[i - 1] = gathered_samples[i * gathered_samples.size() / size];
+    }
+    return pivots;
+}
+
+/**
+ * @brief Troca de dados entre processos para vetores de tipo trivial já ordenados.
+ *
+ * Como a partição local está ordenada, o bucket destinado a cada processo é um intervalo
+ * contíguo delimitado por upper_bound nos pivôs, e todos os buckets seguem em um único
+ * alltoallv sem cópias intermediárias.
+ *
+ * @param comm Comunicador.
+ * @param sorted_local Partição local ordenada.
+ * @param pivots Pivôs globais.
+ * @return Elementos recebidos: concatenação de size sequências ordenadas, em ordem de rank.
+ */
+template <typename T>
+std::vector<T> exchange_sorted(Comm& comm, const std::vector<T>& sorted_local, const std::vector<T>& pivots) {
+    int size = comm.size();
+    std::vector<std::size_t> send_counts(size);
+    std::size_t begin = 0;
+    for (int p = 0; p < size; p++) {
+        std::size_t end = (p < size - 1)
+            ? std::upper_bound(sorted_local.begin() + begin, sorted_local.end(), pivots[p]) - sorted_local.begin()
+            : sorted_local.size();
+        send_counts[p] = end - begin;
+        begin = end;
+    }
+    return alltoallv_pod(comm, sorted_local, send_counts);
+}
+
+/**
+ * @brief Pivôs globais para uma partição local ordenada de tipo trivial (amostras, coleta,
+ *        escolha no MASTER e difusão).
+ * @param comm Comunicador.
+ * @param sorted_local Partição local ordenada.
+ * @return Pivôs globais (size - 1) em todos os processos.
+ */
+template <typename T>
+std::vector<T> sample_pivots(Comm& comm, const std::vector<T>& sorted_local) {
+    int size = comm.size();
+    std::vector<T> samples = select_samples(sorted_local, size - 1);
+    std::vector<T> gathered_samples = gather_pod(comm, samples);
+    std::vector<T> pivots;
+    if (comm.rank() == MASTER) pivots = choose_pivots(gathered_samples, size);
+    bcast_pod(comm, pivots);
+    return pivots;
+}
+
+} // namespace dnasort
+
+#endif // PARALLEL_SORT_H
@@ -0,0 +1,199 @@
+/**
+ * @file PerfModel.cpp
+ * @brief Implementação do modelo de desempenho do Sample Sort.
+ */
+
+#include "PerfModel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+#include "DnaSort.h"
+#include "MappedFile.h"
+#include "ParallelSort.h"
+
+using namespace std;
+
+namespace dnasort {
+
+#define MIN_MEASURE_SECONDS 0.02 ///< Medições mais curtas são repetidas até este tempo.
+#define SAMPLE_SEED 12345
+
+/**
+ * @brief Segundos decorridos desde start.
+ */
+static double seconds_since(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+double LogGP::message(double bytes) const {
+    return L + 2 * o + max(bytes - 1, 0.0) * G;
+}
+
+/**
+ * As mensagens da raiz saem (ou chegam) uma após a outra: cada uma ocupa a raiz por max(o, g)
+ * e cada parte é enviada em duas mensagens (tamanho e dados), como em send_strings.
+ */
+double LogGP::root_serial(int ranks, double total_bytes) const {
+    if (ranks <= 1) return 0;
+    return L + 2 * o + (ranks - 1) * 2 * max(o, g) + total_bytes * G;
+}
+
+double LogGP::bcast(int ranks, double bytes) const {
+    if (ranks <= 1) return 0;
+    double rounds = ceil(log2((double)ranks));
+    return rounds * (message(sizeof(int)) + message(bytes));
+}
+
+/**
+ * Em cada uma das P - 1 rodadas, cada processo envia um bucket e recebe outro; a contagem
+ * inicial dos tamanhos (alltoall de inteiros) usa log P rodadas (algoritmo de Bruck).
+ */
+double LogGP::alltoallv(int ranks, double bytes) const {
+    if (ranks <= 1) return 0;
+    double rounds = ceil(log2((double)ranks));
+    double counts = rounds * message(ranks / 2.0 * sizeof(int));
+    return counts + (ranks - 1) * (L + 2 * o) + bytes * (ranks - 1) / ranks * G;
+}
+
+double ModelPrediction::total() const {
+    return read + distribute + local_sort + samples + pivots + exchange + final_sort + gather + write;
+}
+
+SortModel::SortModel(const vector<string>& sample, uint64_t n, const ModelConfig& config)
+    : sample_(sample), n_(n), config_(config), bytes_per_seq_(0), convert_per_seq_(0) {
+    for (const auto& seq : sample_) bytes_per_seq_ += seq.size() + 1;
+    if (!sample_.empty()) bytes_per_seq_ /= sample_.size();
+
+    if (config_.canonical && !sample_.empty()) {
+        // Conversão para chaves canônicas (antes da ordenação local) e de volta (após a final)
+        vector<string> keys(sample_);
+        auto start = chrono::steady_clock::now();
+        for (auto& seq : keys) to_canonical_key(seq);
+        vector<string> back(keys);
+        for (auto& key : back) from_canonical_key(key);
+        convert_per_seq_ = seconds_since(start) / sample_.size();
+        sample_.swap(keys);
+    }
+
+    sorted_sample_ = sample_;
+    std::sort(sorted_sample_.begin(), sorted_sample_.end());
+}
+
+/**
+ * Ordena as primeiras min(count, |amostra|) sequências da amostra (em ordem aleatória ou em runs
+ * ordenadas) e extrapola o tempo por count log count. Tempos curtos são medidos em repetições.
+ */
+double SortModel::sort_seconds(uint64_t count, int runs) {
+    if (count <= 1 || sample_.empty()) return 0;
+    uint64_t m = min<uint64_t>(count, sample_.size());
+    if ((uint64_t)runs > m) runs = 0;
+    auto it = sort_times_.find(make_pair(m, runs));
+    if (it == sort_times_.end()) {
+        double elapsed = 0;
+        int repetitions = 0;
+        while (elapsed < MIN_MEASURE_SECONDS) {
+            vector<string> data(sample_.begin(), sample_.begin() + m);
+            for (int r = 0; r < runs; r++) std::sort(data.begin() + r * m / runs, data.begin() + (r + 1) * m / runs);
+            auto start = chrono::steady_clock::now();
+            sequential_sort(data);
+            elapsed += seconds_since(start);
+            repetitions++;
+        }
+        it = sort_times_.insert(make_pair(make_pair(m, runs), elapsed / repetitions)).first;
+    }
+    if (m < 2) return it->second;
+    return it->second * (count * log2((double)count)) / (m * log2((double)m));
+}
+
+ModelPrediction SortModel::predict(int ranks) {
+    ModelPrediction pred;
+    pred.ranks = ranks;
+    const LogGP& net = config_.net;
+    double total_bytes = n_ * bytes_per_seq_;
+    uint64_t local_count = (n_ + ranks - 1) / ranks;
+
+    pred.read = total_bytes / config_.disk_bytes_per_second;
+    pred.distribute = net.root_serial(ranks, total_bytes * (ranks - 1) / ranks);
+    pred.local_sort = sort_seconds(local_count) + local_count * convert_per_seq_ / 2;
+
+    if (ranks > 1 && !sorted_sample_.empty()) {
+        // Pivôs pelo algoritmo da ordenação: amostras regulares de P partições da amostra.
+        // Sem P - 1 sequências por partição, usa os quantis da amostra inteira.
+        vector<string> pivots;
+        size_t piece = sample_.size() / ranks;
+        if (piece >= (size_t)(ranks - 1)) {
+            vector<string> gathered;
+            for (int p = 0; p < ranks; p++) {
+                vector<string> local(sample_.begin() + p * piece, sample_.begin() + (p + 1) * piece);
+                std::sort(local.begin(), local.end());
+                vector<string> samples = select_samples(local, ranks - 1);
+                gathered.insert(gathered.end(), samples.begin(), samples.end());
+            }
+            auto start = chrono::steady_clock::now();
+            pivots = choose_pivots(gathered, ranks);
+            pred.pivots = seconds_since(start);
+        } else {
+            for (int i = 1; i < ranks; i++) pivots.push_back(sorted_sample_[i * sorted_sample_.size() / ranks]);
+            pred.pivots = sort_seconds((uint64_t)ranks * (ranks - 1));
+        }
+        pred.pivots += net.bcast(ranks, (ranks - 1) * bytes_per_seq_);
+        pred.samples = net.root_serial(ranks, (double)(ranks - 1) * (ranks - 1) * bytes_per_seq_);
+
+        // Maior faixa da amostra em relação à média
+        size_t begin = 0, largest = 0;
+        for (int p = 0; p < ranks; p++) {
+            size_t end = (p < ranks - 1)
+                ? upper_bound(sorted_sample_.begin() + begin, sorted_sample_.end(), pivots[p]) - sorted_sample_.begin()
+                : sorted_sample_.size();
+            largest = max(largest, end - begin);
+            begin = end;
+        }
+        pred.imbalance = (double)largest * ranks / sorted_sample_.size();
+    }
+
+    uint64_t bucket_count = (uint64_t)(pred.imbalance * n_ / ranks);
+    double bucket_bytes = bucket_count * bytes_per_seq_;
+    pred.exchange = net.alltoallv(ranks, max(local_count * bytes_per_seq_, bucket_bytes));
+    pred.final_sort = sort_seconds(bucket_count, ranks) + bucket_count * convert_per_seq_ / 2;
+    if (config_.shards) {
+        pred.write = bucket_bytes / config_.disk_bytes_per_second;
+    } else {
+        pred.gather = net.root_serial(ranks, total_bytes * (ranks - 1) / ranks);
+        pred.write = total_bytes / config_.disk_bytes_per_second;
+    }
+    return pred;
+}
+
+vector<string> sample_lines(const string& filename, size_t count, uint64_t* lines) {
+    MappedFile file(filename);
+    const char* data = file.data();
+    size_t size = file.size();
+
+    // Amostragem por reservatório das linhas não vazias (as mesmas que read_file considera)
+    vector<string> sample;
+    mt19937_64 rng(SAMPLE_SEED);
+    uint64_t seen = 0;
+    for (size_t pos = 0; pos < size; ) {
+        size_t next = next_line(data, size, pos);
+        size_t len = next - pos - (data[next - 1] == '\n' ? 1 : 0);
+        if (len > 0) {
+            if (sample.size() < count) {
+                sample.push_back(string(data + pos, len));
+            } else {
+                uint64_t slot = rng() % (seen + 1);
+                if (slot < count) sample[slot].assign(data + pos, len);
+            }
+            seen++;
+        }
+        pos = next;
+    }
+    // Reservatório preenchido em ordem do arquivo: embaralha para que prefixos sejam aleatórios
+    shuffle(sample.begin(), sample.end(), rng);
+    if (lines) *lines = seen;
+    return sample;
+}
+
+} // namespace dnasort
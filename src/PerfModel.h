@@ -0,0 +1,120 @@
+/**
+ * @file PerfModel.h
+ * @brief Modelo de desempenho do Sample Sort para números de processos que não podem ser testados.
+ *
+ * As fases locais (ordenação local e final, escolha dos pivôs) são executadas de verdade sobre
+ * uma amostra da entrada, e os seus tempos são extrapolados para n / P sequências por O(n log n).
+ * Os pivôs são escolhidos pelo mesmo algoritmo da ordenação (select_samples e choose_pivots)
+ * sobre a amostra dividida em P partições, de modo que o desequilíbrio das faixas é o que os
+ * dados reais produzem. As fases de comunicação (distribuição, coleta das amostras, difusão dos
+ * pivôs, troca e coleta final) seguem o padrão de mensagens de Comm em uma rede LogGP.
+ */
+
+#ifndef PERF_MODEL_H
+#define PERF_MODEL_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace dnasort {
+
+/**
+ * @brief Parâmetros da rede no modelo LogGP (em segundos).
+ */
+struct LogGP {
+    double L = 2e-6;      ///< Latência de uma mensagem.
+    double o = 1e-6;      ///< Sobrecarga do processador para enviar ou receber uma mensagem.
+    double g = 1e-6;      ///< Intervalo mínimo entre mensagens consecutivas de um processo.
+    double G = 0.8e-9;    ///< Tempo por byte de uma mensagem longa (1 / banda; 0.8 ns = 1.25 GB/s).
+
+    /** @brief Tempo de uma mensagem de bytes bytes entre dois processos. */
+    double message(double bytes) const;
+
+    /** @brief Raiz recebe (ou envia) uma mensagem de cada um dos demais P - 1 processos, em sequência. */
+    double root_serial(int ranks, double total_bytes) const;
+
+    /** @brief Difusão em árvore binomial. */
+    double bcast(int ranks, double bytes) const;
+
+    /** @brief Troca de todos para todos em P - 1 rodadas par a par; bytes é o maior volume de um processo. */
+    double alltoallv(int ranks, double bytes) const;
+};
+
+/**
+ * @brief Configuração do modelo.
+ */
+struct ModelConfig {
+    LogGP net;                    ///< Rede.
+    double disk_bytes_per_second = 1e9; ///< Banda de leitura e gravação de arquivos.
+    bool canonical = false;       ///< Ordenação pela forma canônica.
+    bool shards = false;          ///< Cada processo grava a sua faixa (sem coleta no MASTER).
+};
+
+/**
+ * @brief Tempo previsto de cada fase (no processo mais lento) para P processos.
+ */
+struct ModelPrediction {
+    int ranks = 1;           ///< Número de processos.
+    double imbalance = 1;    ///< Maior faixa / faixa média, medido na amostra.
+    double read = 0;         ///< Leitura da entrada no MASTER.
+    double distribute = 0;   ///< Distribuição inicial.
+    double local_sort = 0;   ///< Ordenação local (com a conversão canônica, se for o caso).
+    double samples = 0;      ///< Coleta das amostras no MASTER.
+    double pivots = 0;       ///< Escolha e difusão dos pivôs.
+    double exchange = 0;     ///< Troca de dados.
+    double final_sort = 0;   ///< Ordenação final.
+    double gather = 0;       ///< Coleta do resultado no MASTER.
+    double write = 0;        ///< Gravação da saída.
+
+    /** @brief Soma das fases. */
+    double total() const;
+};
+
+/**
+ * @brief Modelo da ordenação de n sequências com a distribuição de uma amostra.
+ */
+class SortModel {
+public:
+    /**
+     * @param sample Amostra aleatória da entrada (em qualquer ordem).
+     * @param n Número de sequências modelado (pode ser maior que o da entrada).
+     * @param config Rede, disco e modo de execução.
+     */
+    SortModel(const std::vector<std::string>& sample, uint64_t n, const ModelConfig& config);
+
+    /** @brief Previsão para ranks processos. */
+    ModelPrediction predict(int ranks);
+
+    /** @brief Tamanho médio de uma sequência na amostra, com o '\n'. */
+    double bytes_per_sequence() const { return bytes_per_seq_; }
+
+private:
+    /**
+     * @brief Tempo de ordenar count sequências (medido até o tamanho da amostra, extrapolado acima).
+     * @param runs Se > 0, a entrada é a concatenação de runs sequências ordenadas, como na ordenação final.
+     */
+    double sort_seconds(uint64_t count, int runs = 0);
+
+    std::vector<std::string> sample_;         ///< Amostra (chaves canônicas, se for o caso), na ordem original.
+    std::vector<std::string> sorted_sample_;  ///< Amostra ordenada.
+    uint64_t n_;
+    ModelConfig config_;
+    double bytes_per_seq_;
+    double convert_per_seq_;                  ///< Conversão canônica de ida e volta por sequência.
+    std::map<std::pair<uint64_t, int>, double> sort_times_; ///< Tempos medidos por (tamanho, runs).
+};
+
+/**
+ * @brief Amostra aleatória (reservatório, semente fixa) de até count linhas de um arquivo.
+ * @param filename Arquivo de sequências, uma por linha.
+ * @param count Tamanho da amostra.
+ * @param lines Se não nulo, recebe o número de linhas do arquivo.
+ * @return Linhas amostradas; lança runtime_error se o arquivo não pode ser lido.
+ */
+std::vector<std::string> sample_lines(const std::string& filename, std::size_t count, uint64_t* lines);
+
+} // namespace dnasort
+
+#endif // PERF_MODEL_H
@@ -0,0 +1,192 @@
+/**
+ * @file Progress.cpp
+ * @brief Implementação do relatório de progresso.
+ */
+
+#include "Progress.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+namespace dnasort {
+
+#define STALL_INTERVALS 3    ///< Rank parado: sem avanço por este número de intervalos.
+
+static thread_local Progress* thread_progress = 0;
+
+Progress* current_progress() {
+    return thread_progress;
+}
+
+void set_current_progress(Progress* progress) {
+    thread_progress = progress;
+}
+
+Progress::Progress() : start_(chrono::steady_clock::now()), changed_(start_) {
+    state_.phase = "início";
+}
+
+void Progress::set_total(uint64_t bytes) {
+    lock_guard<mutex> lock(mutex_);
+    state_.total_bytes = bytes;
+}
+
+void Progress::phase(const string& name) {
+    lock_guard<mutex> lock(mutex_);
+    state_.phase = name;
+    state_.phase_index++;
+    state_.items = 0;
+    state_.bytes = 0;
+    changed_ = chrono::steady_clock::now();
+}
+
+void Progress::advance(uint64_t items, uint64_t bytes) {
+    lock_guard<mutex> lock(mutex_);
+    state_.items += items;
+    state_.bytes += bytes;
+    state_.done_bytes += bytes;
+    changed_ = chrono::steady_clock::now();
+}
+
+ProgressSnapshot Progress::snapshot() const {
+    lock_guard<mutex> lock(mutex_);
+    auto now = chrono::steady_clock::now();
+    ProgressSnapshot snap = state_;
+    snap.elapsed = chrono::duration<double>(now - start_).count();
+    snap.since_change = chrono::duration<double>(now - changed_).count();
+    return snap;
+}
+
+ProgressReporter::ProgressReporter(int rank, int size, Progress& progress, const string& status_file, double interval)
+    : rank_(rank), size_(size), progress_(progress), status_file_(status_file), interval_(interval), stopping_(false) {
+    thread_ = thread([this] { loop(); });
+}
+
+ProgressReporter::~ProgressReporter() {
+    stop();
+}
+
+void ProgressReporter::loop() {
+    unique_lock<mutex> lock(mutex_);
+    while (!wake_.wait_for(lock, chrono::duration<double>(interval_), [this] { return stopping_; })) {
+        write_rank();
+        if (rank_ == 0) summarize(false);
+    }
+}
+
+void ProgressReporter::stop() {
+    {
+        lock_guard<mutex> lock(mutex_);
+        if (stopping_) return;
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+    write_rank();
+}
+
+string ProgressReporter::rank_filename(int rank) const {
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".rank-%05d", rank);
+    return status_file_ + suffix;
+}
+
+/**
+ * Formato (uma linha): índice da fase, sequências e bytes da fase, bytes totais, estimativa
+ * do total, tempo decorrido, tempo desde o último avanço e o nome da fase.
+ */
+void ProgressReporter::write_rank() const {
+    ProgressSnapshot s = progress_.snapshot();
+    string name = rank_filename(rank_), tmp = name + ".tmp";
+    ofstream file(tmp);
+    file << s.phase_index << " " << s.items << " " << s.bytes << " " << s.done_bytes << " " << s.total_bytes << " "
+         << s.elapsed << " " << s.since_change << " " << s.phase << "\n";
+    file.close();
+    if (!file || rename(tmp.c_str(), name.c_str()) != 0) unlink(tmp.c_str());
+}
+
+void ProgressReporter::remove() const {
+    unlink(rank_filename(rank_).c_str());
+}
+
+void ProgressReporter::summarize(bool final) {
+    // Estado de cada rank (has[p] = false se o arquivo do rank ainda não existe)
+    vector<ProgressSnapshot> ranks(size_);
+    vector<bool> has(size_, false);
+    for (int p = 0; p < size_; p++) {
+        ifstream file(rank_filename(p));
+        ProgressSnapshot& s = ranks[p];
+        if (file >> s.phase_index >> s.items >> s.bytes >> s.done_bytes >> s.total_bytes >> s.elapsed >> s.since_change) {
+            getline(file >> ws, s.phase);
+            has[p] = true;
+        }
+    }
+
+    uint64_t done = 0;
+    double elapsed = ranks[0].elapsed;
+    vector<int> phases;
+    int slowest = -1;
+    for (int p = 0; p < size_; p++) {
+        if (!has[p]) continue;
+        done += ranks[p].done_bytes;
+        phases.push_back(ranks[p].phase_index);
+        if (slowest < 0 || ranks[p].phase_index < ranks[slowest].phase_index) slowest = p;
+    }
+    // Como as fases terminam em operações coletivas, um rank em fase anterior à da maioria atrasa os demais
+    std::sort(phases.begin(), phases.end());
+    int median_phase = phases.empty() ? 0 : phases[phases.size() / 2];
+
+    // Estimativa de término pela vazão agregada até agora
+    uint64_t total = ranks[0].total_bytes;
+    double eta = (!final && total > done && done > 0) ? elapsed * (total - done) / done : 0;
+
+    ostringstream out, warnings;
+    out << fixed << setprecision(1);
+    warnings << fixed << setprecision(1);
+    out << (final ? "concluído" : "em andamento") << " após " << elapsed << " s";
+    if (!final && slowest >= 0) out << "; fase mais atrasada: " << ranks[slowest].phase << " (rank " << slowest << ")";
+    out << "; " << done / 1e6 << " MB processados, " << (elapsed > 0 ? done / elapsed / 1e6 : 0) << " MB/s";
+    if (eta > 0) out << "; término estimado em " << eta << " s";
+    out << "\n";
+
+    for (int p = 0; p < size_; p++) {
+        out << "rank " << p << ": ";
+        if (!has[p]) {
+            out << "sem dados\n";
+            continue;
+        }
+        const ProgressSnapshot& s = ranks[p];
+        double rate = s.elapsed > 0 ? s.done_bytes / s.elapsed / 1e6 : 0;
+        out << s.phase << ", " << s.items << " sequências e " << s.bytes / 1e6 << " MB na fase, "
+            << s.done_bytes / 1e6 << " MB no total, " << rate << " MB/s";
+        if (!final && s.since_change > STALL_INTERVALS * interval_) {
+            out << " [parado há " << s.since_change << " s]";
+            warnings << " rank " << p << " parado há " << s.since_change << " s em " << s.phase << ";";
+        } else if (!final && s.phase_index < median_phase) {
+            out << " [atrasado]";
+            warnings << " rank " << p << " atrasado em " << s.phase << ";";
+        }
+        out << "\n";
+    }
+
+    string tmp = status_file_ + ".tmp";
+    ofstream file(tmp);
+    file << out.str();
+    file.close();
+    if (!file || rename(tmp.c_str(), status_file_.c_str()) != 0) unlink(tmp.c_str());
+
+    string summary = out.str();
+    cerr << "[progresso] " << summary.substr(0, summary.find('\n'));
+    if (!warnings.str().empty()) cerr << "; atenção:" << warnings.str();
+    cerr << endl;
+}
+
+} // namespace dnasort
@@ -0,0 +1,141 @@
+/**
+ * @file Progress.h
+ * @brief Relatório periódico de progresso das execuções longas.
+ *
+ * A thread principal de cada rank registra a fase atual e o volume processado em um Progress
+ * (operações baratas, sob um mutex). Uma thread de relatório por rank grava esse estado, a cada
+ * intervalo, em "<status>.rank-NNNNN"; a do MASTER reúne os arquivos de todos os ranks em
+ * "<status>" e imprime um resumo na saída de erro, com a fase, o volume, a vazão por rank, a
+ * estimativa de término e os ranks atrasados ou parados. Nenhuma comunicação entre ranks é feita
+ * durante a execução (o MPI não precisa de suporte a threads); entre nós diferentes, <status>
+ * deve estar em um sistema de arquivos compartilhado.
+ *
+ * Os algoritmos da biblioteca registram as suas fases com progress_phase e progress_advance,
+ * que não fazem nada se a thread atual não tem um Progress (set_current_progress).
+ */
+
+#ifndef PROGRESS_H
+#define PROGRESS_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dnasort {
+
+/**
+ * @brief Estado de progresso de um rank em um instante.
+ */
+struct ProgressSnapshot {
+    std::string phase;        ///< Nome da fase atual.
+    int phase_index = 0;      ///< Número de fases iniciadas.
+    uint64_t items = 0;       ///< Sequências processadas na fase atual.
+    uint64_t bytes = 0;       ///< Bytes processados na fase atual.
+    uint64_t done_bytes = 0;  ///< Bytes processados em todas as fases.
+    uint64_t total_bytes = 0; ///< Estimativa do trabalho total em bytes (0 se desconhecida).
+    double elapsed = 0;       ///< Segundos desde o início.
+    double since_change = 0;  ///< Segundos desde o último avanço.
+};
+
+/**
+ * @brief Contadores de progresso de um rank.
+ */
+class Progress {
+public:
+    Progress();
+
+    /** @brief Estimativa do trabalho total (soma dos bytes de todas as fases de todos os ranks). */
+    void set_total(uint64_t bytes);
+
+    /** @brief Inicia uma fase. */
+    void phase(const std::string& name);
+
+    /** @brief Registra sequências e bytes processados na fase atual. */
+    void advance(uint64_t items, uint64_t bytes);
+
+    ProgressSnapshot snapshot() const;
+
+private:
+    mutable std::mutex mutex_;
+    ProgressSnapshot state_;
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::steady_clock::time_point changed_;
+};
+
+/** @brief Progress da thread atual (nulo se não há relatório). */
+Progress* current_progress();
+
+/** @brief Define o Progress da thread atual (cada rank-thread tem o seu). */
+void set_current_progress(Progress* progress);
+
+/** @brief Inicia uma fase no Progress da thread atual, se houver. */
+inline void progress_phase(const char* name) {
+    if (Progress* p = current_progress()) p->phase(name);
+}
+
+/** @brief Registra avanço no Progress da thread atual, se houver. */
+inline void progress_advance(uint64_t items, uint64_t bytes) {
+    if (Progress* p = current_progress()) p->advance(items, bytes);
+}
+
+/** @brief Registra como processadas as sequências de data (o tamanho só é somado se houver Progress). */
+inline void progress_advance(const std::vector<std::string>& data) {
+    if (Progress* p = current_progress()) {
+        uint64_t bytes = 0;
+        for (const auto& seq : data) bytes += seq.size() + 1;
+        p->advance(data.size(), bytes);
+    }
+}
+
+/**
+ * @brief Thread que grava periodicamente o progresso de um rank (e, no MASTER, o resumo de todos).
+ */
+class ProgressReporter {
+public:
+    /**
+     * @param rank Rank atual.
+     * @param size Número de ranks.
+     * @param progress Contadores do rank.
+     * @param status_file Arquivo de estado; os ranks gravam em "<status_file>.rank-NNNNN".
+     * @param interval Intervalo entre relatórios, em segundos.
+     */
+    ProgressReporter(int rank, int size, Progress& progress, const std::string& status_file, double interval);
+    ~ProgressReporter();
+
+    /**
+     * @brief Encerra a thread e grava o estado final do rank.
+     *
+     * No MASTER, depois que todos os ranks chamaram stop (por exemplo, após uma barreira),
+     * summarize(true) grava o resumo final; remove() apaga o arquivo do rank.
+     */
+    void stop();
+
+    /** @brief Reúne os arquivos dos ranks em status_file e imprime o resumo (apenas no MASTER). */
+    void summarize(bool final);
+
+    /** @brief Remove o arquivo de estado deste rank. */
+    void remove() const;
+
+private:
+    void loop();
+    void write_rank() const;
+    std::string rank_filename(int rank) const;
+
+    int rank_;
+    int size_;
+    Progress& progress_;
+    std::string status_file_;
+    double interval_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_;
+    std::thread thread_;
+};
+
+} // namespace dnasort
+
+#endif // PROGRESS_H
@@ -0,0 +1,256 @@
+/**
+ * @file ResultCache.cpp
+ * @brief Implementação do cache de resultados.
+ */
+
+#include "ResultCache.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Collation.h"
+#include "MappedFile.h"
+
+using namespace std;
+
+namespace dnasort {
+
+#define HASH_CHUNK_BYTES (8u << 20)  ///< Tamanho dos blocos do hash (fixo, para independer das threads).
+
+namespace {
+
+/**
+ * @brief Estado do hash: duas faixas de 64 bits com constantes independentes.
+ */
+struct Hash128 {
+    uint64_t h1 = 0x9e3779b97f4a7c15ULL;
+    uint64_t h2 = 0xc2b2ae3d27d4eb4fULL;
+
+    static uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+    static uint64_t fmix(uint64_t k) {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdULL;
+        k ^= k >> 33;
+        k *= 0xc4ceb9fe1a85ec53ULL;
+        return k ^ (k >> 33);
+    }
+
+    void word(uint64_t w) {
+        h1 = rotl(h1 ^ (w * 0x87c37b91114253d5ULL), 31) * 0x4cf5ad432745937fULL;
+        h2 = rotl(h2 ^ (w * 0x52dce729da3ed4b9ULL), 33) * 0x38495ab5a8d2c1e7ULL + h1;
+    }
+
+    void bytes(const char* data, size_t len) {
+        size_t i = 0;
+        for (; i + 8 <= len; i += 8) {
+            uint64_t w;
+            memcpy(&w, data + i, 8);
+            word(w);
+        }
+        uint64_t tail = 0;
+        memcpy(&tail, data + i, len - i);
+        word(tail ^ ((uint64_t)len << 56));
+    }
+
+    void finish() {
+        h1 = fmix(h1 + h2);
+        h2 = fmix(h2 + h1);
+    }
+};
+
+/**
+ * @brief Copia src para dst (substituindo dst).
+ */
+bool copy_file(const string& src, const string& dst) {
+    ifstream in(src, ios::binary);
+    ofstream out(dst, ios::binary | ios::trunc);
+    if (!in.is_open() || !out.is_open()) return false;
+    out << in.rdbuf();
+    out.close();
+    return !out.fail();
+}
+
+/**
+ * @brief Cria dst como hard link para src (se allow_link e src não tem outros links) ou como cópia.
+ *
+ * Assim, duas saídas nunca compartilham o mesmo arquivo: gravar sobre uma delas não altera a
+ * outra (e uma entrada do cache alterada por uma saída ligada a ela é detectada pelo hash).
+ * O destino é criado com outro nome e renomeado, de modo que um dst existente é substituído e
+ * não sobrescrito.
+ */
+bool link_or_copy(const string& src, const string& dst, bool allow_link) {
+    string tmp = dst + ".tmp";
+    unlink(tmp.c_str());
+    struct stat st;
+    bool linked = allow_link && stat(src.c_str(), &st) == 0 && st.st_nlink == 1 && link(src.c_str(), tmp.c_str()) == 0;
+    if (!linked && !copy_file(src, tmp)) return false;
+    if (rename(tmp.c_str(), dst.c_str()) != 0) {
+        unlink(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+uint64_t file_size(const string& filename) {
+    struct stat st;
+    return stat(filename.c_str(), &st) == 0 ? st.st_size : 0;
+}
+
+} // namespace
+
+string hash_file(const string& filename, int threads) {
+    MappedFile file(filename);
+    size_t chunks = (file.size() + HASH_CHUNK_BYTES - 1) / HASH_CHUNK_BYTES;
+    vector<Hash128> digests(chunks);
+
+    // Blocos distribuídos dinamicamente entre as threads
+    if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+    threads = (int)min<size_t>(threads, max<size_t>(chunks, 1));
+    atomic<size_t> next(0);
+    auto worker = [&] {
+        for (size_t c = next++; c < chunks; c = next++) {
+            size_t begin = c * (size_t)HASH_CHUNK_BYTES;
+            digests[c].bytes(file.data() + begin, min<size_t>(HASH_CHUNK_BYTES, file.size() - begin));
+            digests[c].finish();
+        }
+    };
+    vector<thread> pool;
+    for (int t = 1; t < threads; t++) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+
+    // Combinação dos blocos em ordem
+    Hash128 total;
+    for (const auto& d : digests) {
+        total.word(d.h1);
+        total.word(d.h2);
+    }
+    total.word(file.size());
+    total.finish();
+
+    char hex[33];
+    snprintf(hex, sizeof(hex), "%016llx%016llx", (unsigned long long)total.h1, (unsigned long long)total.h2);
+    return hex;
+}
+
+string sort_cache_options(const SortOptions& opts, size_t index_block) {
+    string desc = "sort canonical=" + to_string(opts.canonical) + " index=" + to_string(index_block);
+    if (opts.collation != Collation::LEXICOGRAPHIC) desc += " order=" + collation_name(opts);
+    if (opts.key_field > 0) desc += " key=" + to_string(opts.key_field) + " delimiter=" + to_string((int)opts.delimiter);
+    if (opts.key_prefix > 0) desc += " prefix=" + to_string(opts.key_prefix);
+    return desc;
+}
+
+ResultCache::ResultCache(const string& dir, uint64_t max_bytes) : dir_(dir), max_bytes_(max_bytes) {
+    if (mkdir(dir_.c_str(), 0755) != 0 && errno != EEXIST) {
+        throw runtime_error("Erro ao criar o diretório do cache: " + dir_);
+    }
+}
+
+string ResultCache::key(const string& input, const string& options, int threads) {
+    Hash128 h;
+    h.bytes(options.data(), options.size());
+    h.finish();
+    char hex[18];
+    snprintf(hex, sizeof(hex), "-%016llx", (unsigned long long)h.h1);
+    return hash_file(input, threads) + hex;
+}
+
+string ResultCache::path(const string& key, const char* suffix) const {
+    return dir_ + "/" + key + suffix;
+}
+
+bool ResultCache::fetch(const string& key, const string& output, bool index, int threads) {
+    ifstream meta(path(key, ".meta"));
+    uint64_t bytes;
+    string word, hash;
+    if (!(meta >> word >> bytes >> word >> hash)) return false;
+
+    // A entrada é conferida antes do uso: um link pode ter sido sobrescrito por outra execução
+    string cached = path(key, ".out");
+    try {
+        if (file_size(cached) != bytes || hash_file(cached, threads) != hash) return false;
+    } catch (const exception&) {
+        return false;
+    }
+    if (index && access(path(key, ".out.idx").c_str(), R_OK) != 0) return false;
+
+    if (!link_or_copy(cached, output, true)) return false;
+    if (index && !link_or_copy(path(key, ".out.idx"), output + ".idx", true)) return false;
+
+    // Marca o uso (ordem de remoção)
+    utime(path(key, ".meta").c_str(), 0);
+    return true;
+}
+
+void ResultCache::store(const string& key, const string& output, bool index, int threads) {
+    string hash;
+    try {
+        hash = hash_file(output, threads);
+    } catch (const exception&) {
+        return;
+    }
+    if (!link_or_copy(output, path(key, ".out"), false)) return;
+    if (index && !link_or_copy(output + ".idx", path(key, ".out.idx"), false)) return;
+
+    // O meta é gravado por último: sem ele, a entrada não é usada
+    string meta = path(key, ".meta"), tmp = meta + ".tmp";
+    ofstream file(tmp);
+    file << "bytes " << file_size(output) << "\nhash " << hash << "\n";
+    file.close();
+    if (!file || rename(tmp.c_str(), meta.c_str()) != 0) {
+        unlink(tmp.c_str());
+        return;
+    }
+    evict(key);
+}
+
+void ResultCache::evict(const string& keep) {
+    // Entradas (pelo .meta) com o tamanho total e a data do último uso
+    struct Entry {
+        double used;
+        uint64_t bytes;
+        string key;
+        bool operator<(const Entry& other) const { return used < other.used; }
+    };
+    vector<Entry> entries;
+    uint64_t total = 0;
+    DIR* d = opendir(dir_.c_str());
+    if (!d) return;
+    while (struct dirent* e = readdir(d)) {
+        string name = e->d_name;
+        if (name.size() <= 5 || name.compare(name.size() - 5, 5, ".meta") != 0) continue;
+        string key = name.substr(0, name.size() - 5);
+        struct stat st;
+        if (stat(path(key, ".meta").c_str(), &st) != 0) continue;
+        Entry entry = {st.st_mtim.tv_sec + st.st_mtim.tv_nsec * 1e-9, file_size(path(key, ".out")) + file_size(path(key, ".out.idx")), key};
+        total += entry.bytes;
+        entries.push_back(entry);
+    }
+    closedir(d);
+
+    std::sort(entries.begin(), entries.end());
+    for (size_t i = 0; i < entries.size() && total > max_bytes_; i++) {
+        if (entries[i].key == keep) continue;
+        unlink(path(entries[i].key, ".meta").c_str());
+        unlink(path(entries[i].key, ".out").c_str());
+        unlink(path(entries[i].key, ".out.idx").c_str());
+        total -= entries[i].bytes;
+    }
+}
+
+} // namespace dnasort
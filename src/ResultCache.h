@@ -0,0 +1,88 @@
+/**
+ * @file ResultCache.h
+ * @brief Cache de resultados indexado pelo conteúdo da entrada e pelas opções.
+ *
+ * Execuções repetidas sobre uma entrada inalterada reaproveitam a saída gravada anteriormente:
+ * a chave é o hash do conteúdo da entrada (calculado em paralelo, por blocos) combinado com as
+ * opções que afetam o resultado. Na presença da chave, a saída é um hard link para a entrada do
+ * cache (ou uma cópia, se a entrada já está ligada a outra saída ou o link não é possível),
+ * conferida pelo hash antes do uso. As entradas são gravadas como cópias da saída. O tamanho
+ * total do cache é limitado; as entradas usadas há mais tempo são removidas primeiro.
+ *
+ * Arquivos de cada entrada, em <dir>: "<chave>.out", "<chave>.out.idx" (com índice esparso) e
+ * "<chave>.meta" (tamanho e hash da saída; a data de modificação marca o último uso).
+ */
+
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "DnaSort.h"
+
+namespace dnasort {
+
+/**
+ * @brief Hash de 128 bits (não criptográfico) do conteúdo de um arquivo.
+ *
+ * O arquivo é dividido em blocos de tamanho fixo, processados em paralelo; o resultado não
+ * depende do número de threads.
+ *
+ * @param filename Nome do arquivo.
+ * @param threads Número de threads (0 usa o número de núcleos).
+ * @return Hash em 32 dígitos hexadecimais. Lança runtime_error se o arquivo não pode ser lido.
+ */
+std::string hash_file(const std::string& filename, int threads = 0);
+
+/**
+ * @brief Descrição das opções da ordenação completa para ResultCache::key.
+ *
+ * SequentialSort e SampleSort gravam a mesma saída para as mesmas opções e compartilham as
+ * entradas do cache.
+ */
+std::string sort_cache_options(const SortOptions& opts, std::size_t index_block);
+
+/**
+ * @brief Cache de saídas em um diretório, com tamanho total limitado.
+ */
+class ResultCache {
+public:
+    /**
+     * @param dir Diretório do cache (criado se não existe).
+     * @param max_bytes Tamanho máximo das entradas; o excesso é removido a cada store.
+     */
+    ResultCache(const std::string& dir, uint64_t max_bytes);
+
+    /**
+     * @brief Chave de uma execução.
+     * @param input Arquivo de entrada.
+     * @param options Descrição das opções que afetam o resultado.
+     * @param threads Threads do hash da entrada (0 usa o número de núcleos).
+     */
+    static std::string key(const std::string& input, const std::string& options, int threads = 0);
+
+    /**
+     * @brief Com a chave presente e íntegra, cria output (e output.idx, se index) a partir do cache.
+     * @return true em caso de acerto.
+     */
+    bool fetch(const std::string& key, const std::string& output, bool index, int threads = 0);
+
+    /**
+     * @brief Guarda output (e output.idx, se index) sob a chave e remove as entradas mais antigas além do limite.
+     */
+    void store(const std::string& key, const std::string& output, bool index, int threads = 0);
+
+private:
+    std::string path(const std::string& key, const char* suffix) const;
+    /** @brief Remove as entradas usadas há mais tempo até o limite, exceto keep. */
+    void evict(const std::string& keep);
+
+    std::string dir_;
+    uint64_t max_bytes_;
+};
+
+} // namespace dnasort
+
+#endif // RESULT_CACHE_H
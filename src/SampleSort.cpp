@@ -7,278 +7,1155 @@
  * e redistribui os dados de acordo com esses pivôs. No final, cada processo ordena seus dados
  * finais e o processo mestre reúne os resultados ordenados em um único arquivo de saída.
  *
+ * Os algoritmos estão na biblioteca (DnaSort.h, ParallelSort.h, KmerCount.h, SuffixArray.h, SetOps.h, SegmentedSort.h);
+ * este programa trata os argumentos, a entrada e saída e a medição dos tempos. Com --threads N
+ * os ranks são threads de um único processo (ThreadComm) e o MPI não é usado; compilado com
+ * -DDNASORT_NO_MPI, o programa não depende do MPI e usa sempre threads.
+ *
  * Funções principais:
- * - sequential_sort: Ordena um vetor de sequências de DNA em ordem lexicográfica.
- * - read_file: Lê um arquivo texto contendo sequências de DNA (uma por linha).
- * - write_file: Escreve as sequências ordenadas em um arquivo texto (uma por linha).
+ * - run_sample_sort: Ordena com dnasort::sort e grava o resultado no processo mestre (ou uma faixa por processo).
+ * - run_top_k: Seleção distribuída das K menores (ou maiores) sequências por torneio.
+ * - run_select_ranks: Seleção múltipla distribuída das sequências em posições globais dadas.
+ * - run_segmented_sort: Ordena as sequências dentro de cada segmento, com cada segmento inteiro em um processo.
+ * - run_kmer_count: Contagem distribuída de k-mers usando o particionamento por pivôs do Sample Sort.
+ * - run_suffix_array: Vetor de sufixos distribuído por duplicação de prefixos sobre o Sample Sort.
+ * - run_set_operation: Junção, interseção ou diferença entre a entrada e um segundo arquivo.
+ * - run_merge: Intercalação distribuída de arquivos já ordenados.
+ * - run_manifest: Modo lote; processa os pares (entrada, saída) de um manifesto com leitura antecipada.
+ * - run_daemon: Modo serviço; os processos permanecem ativos e executam jobs de um diretório.
  *
  * Execução:
- *   mpirun -np <N> ./ParallelSampleSort <arquivo_entrada> <arquivo_saida>
+ *   mpirun -np <N> ./ParallelSampleSort <arquivo_entrada> <arquivo_saida> [opções]
+ *   mpirun -np <N> ./ParallelSampleSort --merge <a1,a2,...> <arquivo_saida>
+ *   mpirun -np <N> ./ParallelSampleSort --manifest <arquivo> [opções]
+ *   mpirun -np <N> ./ParallelSampleSort --daemon <diretório> [--groups G]
  *
  * Argumentos:
  *   arquivo_entrada - Caminho para o arquivo contendo as sequências de DNA.
  *   arquivo_saida   - Caminho para o arquivo onde as sequências ordenadas serão gravadas.
+ *
+ * Opções:
+ *   --top K    - Grava apenas as K menores sequências, em ordem, sem ordenar o restante.
+ *   --bottom K - Grava apenas as K maiores sequências, em ordem crescente.
+ *   --ranks r1,r2,...     - Grava as sequências nas posições globais (base 0) da ordem final.
+ *   --quantiles q1,q2,... - Grava as sequências nos quantis dados (0 <= q <= 1).
+ *   --canonical - Ordena cada sequência pela sua forma canônica (combinável com os demais modos).
+ *   --order O   - Ordem das sequências na ordenação e na seleção: lex (padrão), length, reverse ou
+ *                 uma permutação de ACGT, como ACTG (ver Collation.h).
+ *   --key-field N - Ordena registros delimitados (TSV, CSV) pelo campo N (base 1), com as linhas
+ *                   inteiras como carga; --delimiter C define o separador (padrão tab).
+ *   --key-prefix K - Ordena apenas pelas primeiras K bases (1 <= K <= 21), com os empates na ordem
+ *                    da entrada; as chaves são inteiros de 3 bits por base (ver sort_by_prefix).
+ *   --segments - Cada linha é "segmento<tab>sequência" (ou com o separador de --delimiter); ordena
+ *                as sequências dentro de cada segmento, com os segmentos em ordem crescente e
+ *                cada um inteiro em um único processo (ver SegmentedSort.h).
+ *   --kmer-count K - Grava os pares (k-mer, contagem) ordenados em formato binário (1 <= K <= 32).
+ *   --suffix-array - Grava o vetor de sufixos binário do texto formado pelas sequências separadas por '$'.
+ *   --join B      - Grava "seq<tab>contagem_entrada<tab>contagem_B" para cada sequência presente na entrada e em B.
+ *   --intersect B - Grava as sequências da entrada (com repetições) que ocorrem no arquivo B.
+ *   --subtract B  - Grava as sequências da entrada (com repetições) que não ocorrem no arquivo B.
+ *   --threads N - Executa com N threads em vez de processos MPI.
+ *   --merge a1,a2,... - Intercala arquivos já ordenados em arquivo_saida, sem reordenar.
+ *   --stream MB - Coleta e grava a saída em fluxo, em blocos de até MB megabytes, sem reunir todo o
+ *                 resultado na memória do processo mestre (ver GatherWrite.h).
+ *   --shards  - Cada processo grava a sua faixa da ordem global em "<arquivo_saida>.shard-NNNNN" e
+ *               arquivo_saida recebe o manifesto com os pivôs e as contagens (ver Shards.h).
+ *   --save-splitters ARQ - Grava em ARQ os pivôs usados, para reutilização em execuções seguintes.
+ *   --load-splitters ARQ - Usa os pivôs de ARQ (ou de um manifesto de --shards) em vez da amostragem,
+ *                          se o desequilíbrio das faixas não passar de --max-imbalance (padrão 1.5).
+ *   --checkpoint DIR - Salva em DIR a run ordenada de cada processo e, após a troca, a partição
+ *                      final e os pivôs (ver Checkpoint.h); os arquivos são removidos ao final.
+ *   --resume  - Com --checkpoint, retoma da fase mais avançada salva por todos os processos.
+ *   --cache-dir DIR - Reaproveita a saída de uma execução anterior sobre a mesma entrada e opções
+ *                     (ver ResultCache.h); --cache-max-mb N limita o tamanho do cache (padrão 1024).
+ *   --progress S - A cada S segundos, grava o progresso de cada processo e imprime um resumo com a
+ *                  fase, a vazão, a estimativa de término e os processos atrasados ou parados (ver Progress.h).
+ *   --status-file ARQ - Arquivo de estado do progresso (padrão dnasort.status; os processos gravam
+ *                       também "ARQ.rank-NNNNN", removidos ao final).
+ *   --index B - Grava também o índice esparso "<arquivo_saida>.idx" com blocos de B linhas (ver IndexQuery.cpp).
+ *   --manifest ARQ - Modo lote: processa cada linha "<entrada> <saída>" de ARQ, lendo a próxima
+ *                    entrada enquanto a atual é processada.
+ *   --daemon DIR - Modo serviço: executa os jobs "*.job" de DIR até existir DIR/STOP (ver JobQueue.h).
+ *   --groups G   - No modo serviço, divide os processos em G grupos que executam jobs em paralelo.
  */
 
 #include <iostream>
-#include <fstream>
 #include <vector>
 #include <string>
+#include <cstdlib>
 #include <algorithm>
-#include <numeric>
-#include <mpi.h>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <sstream>
+#include <thread>
+#include <sys/stat.h>
 
-#define MASTER 0
+#include "DnaSort.h"
+#include "Collation.h"
+#include "ParallelSort.h"
+#include "KmerCount.h"
+#include "SuffixArray.h"
+#include "JobQueue.h"
+#include "Merge.h"
+#include "SetOps.h"
+#include "SegmentedSort.h"
+#include "Shards.h"
+#include "GatherWrite.h"
+#include "ResultCache.h"
+#include "SortedIndex.h"
+#include "Progress.h"
+#include "ThreadComm.h"
+#ifndef DNASORT_NO_MPI
+#include "MpiComm.h"
+#endif
 
 using namespace std;
+using namespace dnasort;
+
+#define DAEMON_POLL_MS 200
+#define DEFAULT_CACHE_MB 1024
+#define DEFAULT_STATUS_FILE "dnasort.status"
+#define SORT_PROGRESS_PASSES 6 ///< Passagens da ordenação sobre os dados (leitura, distribuição, duas ordenações, troca e gravação).
+
+/**
+ * @brief Opções de execução lidas da linha de comando.
+ */
+struct Options {
+    string input_filename;   ///< Arquivo de entrada.
+    string output_filename;  ///< Arquivo de saída.
+    int top_k = 0;           ///< Quando > 0, seleciona apenas K sequências em vez de ordenar tudo.
+    bool bottom = false;     ///< Com top_k, seleciona as K maiores em vez das K menores.
+    vector<long long> ranks; ///< Posições globais consultadas (modo de seleção).
+    vector<double> quantiles;///< Quantis consultados (modo de seleção).
+    bool canonical = false;  ///< Ordena pela forma canônica (sequência ou reverso complementar).
+    Collation collation = Collation::LEXICOGRAPHIC; ///< Ordem das sequências.
+    string base_order;       ///< Com Collation::BASES, a ordem das bases.
+    int key_field = 0;       ///< Quando > 0, ordena registros delimitados por este campo (base 1).
+    char delimiter = '\t';   ///< Separador dos campos dos registros.
+    int key_prefix = 0;      ///< Quando > 0, ordena apenas pelas primeiras key_prefix bases.
+    bool segments = false;   ///< Ordena dentro dos segmentos dados pelo primeiro campo de cada linha.
+    int kmer_k = 0;          ///< Quando > 0, conta k-mers de tamanho K em vez de ordenar sequências.
+    bool suffix_array = false; ///< Constrói o vetor de sufixos em vez de ordenar sequências.
+    int threads = 0;         ///< Quando > 0, executa com threads (ThreadComm) em vez de processos MPI.
+    string daemon_dir;       ///< Quando não vazio, atende os jobs deste diretório (modo serviço).
+    string manifest;         ///< Quando não vazio, processa os pares (entrada, saída) deste arquivo (modo lote).
+    vector<string> merge_inputs; ///< Quando não vazio, intercala estes arquivos já ordenados.
+    int groups = 1;          ///< Número de grupos de processos do modo serviço (jobs concorrentes).
+    size_t index_block = 0;  ///< Quando > 0, grava o índice esparso da saída com blocos deste número de linhas.
+    string save_splitters;   ///< Quando não vazio, grava os pivôs usados neste arquivo.
+    string load_splitters;   ///< Quando não vazio, oferece os pivôs deste arquivo à ordenação.
+    double max_imbalance = 1.5; ///< Maior desequilíbrio aceito para os pivôs carregados.
+    size_t stream_bytes = 0; ///< Quando > 0, coleta e grava a saída em fluxo, em blocos deste tamanho.
+    string checkpoint_dir;   ///< Quando não vazio, salva checkpoints das fases da ordenação neste diretório.
+    bool resume = false;     ///< Retoma a ordenação dos checkpoints de checkpoint_dir.
+    string cache_dir;        ///< Quando não vazio, diretório do cache de resultados.
+    uint64_t cache_max_bytes = (uint64_t)DEFAULT_CACHE_MB << 20; ///< Tamanho máximo do cache.
+    double progress_seconds = 0; ///< Quando > 0, intervalo dos relatórios de progresso.
+    string status_file = DEFAULT_STATUS_FILE; ///< Arquivo de estado do progresso.
+    bool shards = false;     ///< Grava uma faixa por processo e um manifesto em vez do arquivo único.
+    string set_filename;     ///< Quando não vazio, segundo arquivo (B) da operação set_op.
+    SetOperation set_op = SetOperation::JOIN; ///< Operação entre a entrada e set_filename.
+};
 
 /**
- * @brief Ordena um vetor de sequências de DNA em ordem lexicográfica.
- * @param data Vetor de strings representando sequências de DNA.
+ * @brief Separa uma lista de valores separados por vírgula.
+ * @param arg Texto no formato "v1,v2,...".
+ * @return Valores em texto, na ordem dada.
  */
-void sequential_sort(vector<string>& data) {
-    sort(data.begin(), data.end());
+vector<string> split_list(const string& arg) {
+    vector<string> items;
+    size_t start = 0;
+    while (start <= arg.size()) {
+        size_t end = arg.find(',', start);
+        if (end == string::npos) end = arg.size();
+        if (end > start) items.push_back(arg.substr(start, end - start));
+        start = end + 1;
+    }
+    return items;
 }
 
 /**
- * @brief Lê arquivo texto com sequências de DNA e retorna vetor de strings.
- * @param filename Nome do arquivo de entrada.
- * @return Vetor de strings contendo as sequências de DNA.
+ * @brief Opções de ordenação da biblioteca correspondentes às opções de execução.
  */
-vector<string> read_file(const string& filename) {
-    ifstream file(filename);
-    if (!file.is_open()) {throw runtime_error("Erro ao abrir o arquivo de entrada: " + filename);}
+SortOptions sort_options(const Options& opts) {
+    SortOptions sort_opts;
+    sort_opts.canonical = opts.canonical;
+    sort_opts.collation = opts.collation;
+    sort_opts.base_order = opts.base_order;
+    sort_opts.key_field = opts.key_field;
+    sort_opts.delimiter = opts.delimiter;
+    sort_opts.key_prefix = opts.key_prefix;
+    return sort_opts;
+}
 
-    vector<string> data;
-    string line;
-    while (getline(file, line)) {
-        if (!line.empty()) { data.push_back(line); }
+/**
+ * @brief Interpreta os argumentos da linha de comando (ou de um job do modo serviço).
+ * @param args Argumentos, sem o nome do programa.
+ * @param opts Estrutura preenchida com as opções lidas.
+ * @return true se os argumentos são válidos, false caso contrário.
+ */
+bool parse_options(const vector<string>& args, Options& opts) {
+    vector<string> positional;
+    bool status_file = false, delimiter = false;
+    for (size_t i = 0; i < args.size(); i++) {
+        const string& arg = args[i];
+        bool has_value = i + 1 < args.size();
+        if ((arg == "--top" || arg == "--bottom") && has_value) {
+            opts.top_k = atoi(args[++i].c_str());
+            opts.bottom = (arg == "--bottom");
+            if (opts.top_k <= 0) return false;
+        } else if (arg == "--kmer-count" && has_value) {
+            opts.kmer_k = atoi(args[++i].c_str());
+            if (opts.kmer_k < 1 || opts.kmer_k > 32) return false;
+        } else if (arg == "--segments") {
+            opts.segments = true;
+        } else if (arg == "--suffix-array") {
+            opts.suffix_array = true;
+        } else if (arg == "--threads" && has_value) {
+            opts.threads = atoi(args[++i].c_str());
+            if (opts.threads <= 0) return false;
+        } else if (arg == "--daemon" && has_value) {
+            opts.daemon_dir = args[++i];
+        } else if (arg == "--merge" && has_value) {
+            opts.merge_inputs = split_list(args[++i]);
+            if (opts.merge_inputs.empty()) return false;
+        } else if (arg == "--manifest" && has_value) {
+            opts.manifest = args[++i];
+        } else if (arg == "--groups" && has_value) {
+            opts.groups = atoi(args[++i].c_str());
+            if (opts.groups <= 0) return false;
+        } else if (arg == "--index" && has_value) {
+            int block = atoi(args[++i].c_str());
+            if (block <= 0) return false;
+            opts.index_block = block;
+        } else if ((arg == "--join" || arg == "--intersect" || arg == "--subtract") && has_value) {
+            if (!opts.set_filename.empty()) return false;
+            opts.set_filename = args[++i];
+            opts.set_op = (arg == "--join") ? SetOperation::JOIN
+                        : (arg == "--intersect") ? SetOperation::INTERSECT : SetOperation::SUBTRACT;
+        } else if (arg == "--save-splitters" && has_value) {
+            opts.save_splitters = args[++i];
+        } else if (arg == "--load-splitters" && has_value) {
+            opts.load_splitters = args[++i];
+        } else if (arg == "--max-imbalance" && has_value) {
+            opts.max_imbalance = atof(args[++i].c_str());
+            if (opts.max_imbalance < 1.0) return false;
+        } else if (arg == "--stream" && has_value) {
+            int mb = atoi(args[++i].c_str());
+            if (mb <= 0) return false;
+            opts.stream_bytes = (size_t)mb << 20;
+        } else if (arg == "--checkpoint" && has_value) {
+            opts.checkpoint_dir = args[++i];
+        } else if (arg == "--resume") {
+            opts.resume = true;
+        } else if (arg == "--cache-dir" && has_value) {
+            opts.cache_dir = args[++i];
+        } else if (arg == "--cache-max-mb" && has_value) {
+            long mb = atol(args[++i].c_str());
+            if (mb <= 0) return false;
+            opts.cache_max_bytes = (uint64_t)mb << 20;
+        } else if (arg == "--progress" && has_value) {
+            opts.progress_seconds = atof(args[++i].c_str());
+            if (opts.progress_seconds <= 0) return false;
+        } else if (arg == "--status-file" && has_value) {
+            opts.status_file = args[++i];
+            status_file = true;
+        } else if (arg == "--shards") {
+            opts.shards = true;
+        } else if (arg == "--canonical") {
+            opts.canonical = true;
+        } else if (arg == "--key-field" && has_value) {
+            opts.key_field = atoi(args[++i].c_str());
+            if (opts.key_field <= 0) return false;
+        } else if (arg == "--key-prefix" && has_value) {
+            opts.key_prefix = atoi(args[++i].c_str());
+            if (opts.key_prefix <= 0 || opts.key_prefix > MAX_KEY_PREFIX) return false;
+        } else if (arg == "--delimiter" && has_value) {
+            if (!parse_delimiter(args[++i], opts.delimiter)) return false;
+            delimiter = true;
+        } else if (arg == "--order" && has_value) {
+            SortOptions order;
+            if (!parse_collation(args[++i], order)) return false;
+            opts.collation = order.collation;
+            opts.base_order = order.base_order;
+        } else if (arg == "--ranks" && has_value) {
+            for (const auto& item : split_list(args[++i])) opts.ranks.push_back(atoll(item.c_str()));
+        } else if (arg == "--quantiles" && has_value) {
+            for (const auto& item : split_list(args[++i])) {
+                double q = atof(item.c_str());
+                if (q < 0.0 || q > 1.0) return false;
+                opts.quantiles.push_back(q);
+            }
+        } else if (arg.compare(0, 2, "--") != 0) {
+            positional.push_back(arg);
+        } else {
+            return false;
+        }
     }
-    file.close();
-    return data;
+    // Nos modos serviço e lote a entrada e a saída vêm de cada job ou linha do manifesto
+    if (!opts.daemon_dir.empty() && !opts.manifest.empty()) return false;
+    if (!opts.merge_inputs.empty()) {
+        // A intercalação usa a ordem lexicográfica dos arquivos e não combina com os demais modos
+        if (positional.size() != 1 || opts.canonical || opts.top_k > 0 || opts.kmer_k > 0 || opts.suffix_array ||
+            !opts.ranks.empty() || !opts.quantiles.empty() || !opts.manifest.empty()) return false;
+        opts.output_filename = positional[0];
+    } else if (opts.daemon_dir.empty() && opts.manifest.empty()) {
+        if (positional.size() != 2) return false;
+        opts.input_filename = positional[0];
+        opts.output_filename = positional[1];
+    } else if (!positional.empty()) {
+        return false;
+    }
+    if (opts.suffix_array && opts.canonical) return false;
+    // As demais ordens valem para a ordenação e a seleção; o índice, a intercalação e as operações entre arquivos supõem a ordem lexicográfica
+    if (opts.collation != Collation::LEXICOGRAPHIC && (opts.kmer_k > 0 || opts.suffix_array || opts.index_block > 0 ||
+                                                       !opts.merge_inputs.empty() || !opts.set_filename.empty())) return false;
+    if (status_file && opts.progress_seconds <= 0) return false;
+    // Os registros são ordenados pelo campo como está, apenas na ordenação completa
+    if (delimiter && opts.key_field == 0 && !opts.segments) return false;
+    if (opts.key_field > 0 && (opts.canonical || opts.collation != Collation::LEXICOGRAPHIC || opts.top_k > 0 ||
+                               opts.kmer_k > 0 || opts.suffix_array || !opts.ranks.empty() || !opts.quantiles.empty() ||
+                               opts.index_block > 0 || !opts.merge_inputs.empty() || !opts.set_filename.empty())) return false;
+    // O prefixo vale só na ordenação completa e não tem pivôs em texto para faixas, pivôs salvos e checkpoints
+    if (opts.key_prefix > 0 && (opts.collation != Collation::LEXICOGRAPHIC || opts.key_field > 0 || opts.top_k > 0 ||
+                                opts.kmer_k > 0 || opts.suffix_array || !opts.ranks.empty() || !opts.quantiles.empty() ||
+                                opts.index_block > 0 || !opts.merge_inputs.empty() || !opts.set_filename.empty() ||
+                                opts.shards || !opts.save_splitters.empty() || !opts.load_splitters.empty() ||
+                                !opts.checkpoint_dir.empty())) return false;
+    // Os segmentos usam o primeiro campo como identificador e são gravados apenas no MASTER
+    if (opts.segments && (opts.key_field > 0 || opts.top_k > 0 || opts.kmer_k > 0 || opts.suffix_array ||
+                          !opts.ranks.empty() || !opts.quantiles.empty() || opts.index_block > 0 ||
+                          !opts.merge_inputs.empty() || !opts.set_filename.empty() || opts.shards ||
+                          opts.stream_bytes > 0 || !opts.save_splitters.empty() || !opts.load_splitters.empty() ||
+                          !opts.checkpoint_dir.empty())) return false;
+    // Saída por faixas, gravação em fluxo, reutilização de pivôs e checkpoints existem apenas para a ordenação completa
+    bool splitters = !opts.save_splitters.empty() || !opts.load_splitters.empty();
+    if (opts.shards && opts.stream_bytes > 0) return false;
+    if (opts.resume && opts.checkpoint_dir.empty()) return false;
+    if ((opts.shards || splitters || opts.stream_bytes > 0 || !opts.checkpoint_dir.empty()) && (opts.top_k > 0 || opts.kmer_k > 0 || opts.suffix_array || !opts.ranks.empty() ||
+                        !opts.quantiles.empty() || !opts.merge_inputs.empty() || !opts.set_filename.empty())) return false;
+    // As operações entre arquivos comparam as sequências como estão e não combinam com os demais modos
+    if (!opts.set_filename.empty() && (opts.canonical || opts.top_k > 0 || opts.kmer_k > 0 || opts.suffix_array ||
+                                       !opts.ranks.empty() || !opts.quantiles.empty() || !opts.merge_inputs.empty() ||
+                                       (opts.index_block > 0 && opts.set_op == SetOperation::JOIN))) return false;
+    // O índice supõe saída em ordem lexicográfica, com uma sequência por linha
+    if (opts.index_block > 0 && (opts.canonical || opts.kmer_k > 0 || opts.suffix_array ||
+                                 !opts.ranks.empty() || !opts.quantiles.empty())) return false;
+    return true;
 }
 
 /**
- * @brief Escreve as sequências ordenadas em um arquivo texto.
- * @param filename Nome do arquivo de saída.
- * @param data Vetor de strings com as sequências ordenadas.
+ * @brief Executa no MASTER a gravação write e informa o resultado a todos os processos.
+ *
+ * Um erro de gravação é impresso no MASTER e devolvido como false em todos os ranks, que
+ * assim saem juntos do modo (e seguem para o próximo arquivo do lote) em vez de o MASTER
+ * encerrar o programa com uma exceção não tratada ou os demais esperarem por ele.
+ *
+ * @param comm Comunicador.
+ * @param write Gravação, chamada apenas no MASTER.
+ * @return true se a gravação foi concluída.
  */
-void write_file(const string& filename, const vector<string>& data) {
-    ofstream file(filename);
-    if (!file.is_open()) {throw runtime_error("Erro ao abrir o arquivo de saída: " + filename);}
+bool write_on_master(Comm& comm, const function<void()>& write) {
+    uint64_t failed = 0;
+    if (comm.rank() == MASTER) {
+        try {
+            write();
+        } catch (const exception& e) {
+            cerr << e.what() << endl;
+            failed = 1;
+        }
+    }
+    comm.bcast(&failed, sizeof(failed), MASTER);
+    return !failed;
+}
 
-    for (const auto& seq : data) {
-        file << seq << "\n";
+/**
+ * @brief Executa o modo --top/--bottom e imprime os tempos.
+ * @param comm Comunicador.
+ * @param local_data Partição local.
+ * @param opts Opções de execução.
+ * @param total_start Instante de início da medição total.
+ * @return false se a gravação da saída falhou.
+ */
+bool run_top_k(Comm& comm, vector<string>& local_data, const Options& opts, double total_start) {
+    int rank = comm.rank();
+    SortOptions sort_opts = sort_options(opts);
+
+    double select_start = comm.wtime();
+    vector<string> result = select_top_k(comm, local_data, opts.top_k, opts.bottom, sort_opts);
+    double select_end = comm.wtime();
+
+    if (!write_on_master(comm, [&] { write_file(opts.output_filename, result, opts.index_block); })) return false;
+
+    double total_end = comm.wtime();
+
+    if (rank == MASTER) {
+        cout << endl << "=== Tempos de execução ===" << endl;
+        cout << "Seleção " << (opts.bottom ? "bottom-" : "top-") << opts.top_k << ":       " << (select_end - select_start) << " segundos" << endl;
+        cout << "Tempo total:          " << (total_end - total_start) << " segundos" << endl;
+        cout << "==========================" << endl;
     }
-    file.close();
+    return true;
 }
 
 /**
- * @brief Função principal. Ordena sequências de DNA paralelamente usando Sample Sort com MPI.
- * @param argc Número de argumentos.
- * @param argv Vetor de argumentos (entrada, saída).
- * @return 0 em caso de sucesso, 1 em erro.
+ * @brief Executa o modo --ranks/--quantiles e imprime os tempos.
+ *
+ * O arquivo de saída contém uma linha "<posição>\t<sequência>" por consulta, na ordem dada.
+ *
+ * @param comm Comunicador.
+ * @param local_data Partição local.
+ * @param opts Opções de execução.
+ * @param n Número total de sequências.
+ * @param total_start Instante de início da medição total.
+ * @return true em caso de sucesso, false se alguma posição está fora do intervalo ou se a
+ *         gravação da saída falhou.
  */
-int main(int argc, char** argv) {
-    MPI_Init(&argc, &argv);
+bool run_select_ranks(Comm& comm, vector<string>& local_data, const Options& opts, int n, double total_start) {
+    int rank = comm.rank();
+    vector<long long> targets(opts.ranks);
+    for (double q : opts.quantiles) {
+        targets.push_back(n > 0 ? (long long)(q * (n - 1)) : 0);
+    }
+    for (long long t : targets) {
+        if (t < 0 || t >= n) {
+            if (rank == MASTER) cerr << "Posição " << t << " fora do intervalo [0, " << n << ")\n";
+            return false;
+        }
+    }
 
-    int rank, size;
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    SortOptions sort_opts = sort_options(opts);
+    SortStats stats;
 
-    if (argc != 3) {
-        if (rank == MASTER) { cerr << "Formato de execução: mpirun -np <N> " << argv[0] << " <arquivo_entrada> <arquivo_saida>\n"; }
-        MPI_Finalize();
-        return 1;
+    double select_start = comm.wtime();
+    vector<string> result = select_ranks(comm, local_data, targets, sort_opts, &stats);
+    double select_end = comm.wtime();
+
+    bool written = write_on_master(comm, [&] {
+        vector<string> lines(result.size());
+        for (size_t j = 0; j < result.size(); j++) lines[j] = to_string(targets[j]) + "\t" + result[j];
+        write_file(opts.output_filename, lines);
+    });
+    if (!written) return false;
+
+    double total_end = comm.wtime();
+
+    if (rank == MASTER) {
+        cout << endl << "=== Tempos de execução ===" << endl;
+        cout << "Ordenação local:      " << stats.local_sort << " segundos" << endl;
+        cout << "Seleção (" << stats.rounds << " rodadas): " << (select_end - select_start - stats.local_sort) << " segundos" << endl;
+        cout << "Tempo total:          " << (total_end - total_start) << " segundos" << endl;
+        cout << "==========================" << endl;
     }
+    return true;
+}
 
-    vector<string> all_data;
-    vector<string> local_data;
-    int n = 0;
+/**
+ * @brief Executa o modo --segments, grava os segmentos ordenados no MASTER e imprime os tempos.
+ *
+ * O identificador do segmento é o texto antes do primeiro separador; uma linha sem separador
+ * pertence ao segmento de identificador vazio, gravado sem o separador.
+ *
+ * @param comm Comunicador.
+ * @param local_data Partição local de linhas (é esvaziada).
+ * @param opts Opções de execução.
+ * @param total_start Instante de início da medição total.
+ * @return false se a gravação da saída falhou.
+ */
+bool run_segmented_sort(Comm& comm, vector<string>& local_data, const Options& opts, double total_start) {
+    int rank = comm.rank();
+    vector<string> ids(local_data.size());
+    for (size_t i = 0; i < local_data.size(); i++) {
+        size_t sep = local_data[i].find(opts.delimiter);
+        if (sep == string::npos) continue;
+        ids[i] = local_data[i].substr(0, sep);
+        local_data[i].erase(0, sep + 1);
+    }
+
+    // Cada rank já é um processo (ou uma thread de --threads): uma thread de segmented_sort por rank
+    SortStats stats;
+    Segments segs = sort_segments(comm, ids, local_data, sort_options(opts), 1, &stats);
+
+    progress_phase("coleta e gravação");
+    double write_start = comm.wtime();
+    vector<string> lines(segs.data.size());
+    for (size_t s = 0; s < segs.ids.size(); s++) {
+        string prefix = segs.ids[s].empty() ? "" : segs.ids[s] + opts.delimiter;
+        for (size_t i = segs.offsets[s]; i < segs.offsets[s + 1]; i++) lines[i] = prefix + segs.data[i];
+    }
+    uint64_t local_segments = segs.ids.size();
+    segs = Segments();
+    progress_advance(lines);
+    vector<string> final_all = comm.gather_strings(lines, MASTER);
+    uint64_t segments = allreduce(comm, local_segments, ReduceOp::SUM);
+    if (!write_on_master(comm, [&] { write_file(opts.output_filename, final_all); })) return false;
+
+    double total_end = comm.wtime();
 
-    // Leitura inicial apenas no processo MASTER
     if (rank == MASTER) {
-        all_data = read_file(argv[1]);
-        n = all_data.size();
+        cout << endl << "=== Tempos de execução ===" << endl;
+        cout << "Agrupamento local:    " << stats.local_sort << " segundos" << endl;
+        cout << "Ordenação segmentos:  " << stats.final_sort << " segundos" << endl;
+        cout << "Coleta e gravação:    " << (total_end - write_start) << " segundos" << endl;
+        cout << "Tempo total:          " << (total_end - total_start) << " segundos" << endl;
+        cout << "Segmentos:            " << segments << endl;
+        cout << "==========================" << endl;
     }
+    return true;
+}
 
-    double total_start = MPI_Wtime();
+/**
+ * @brief Executa o modo --kmer-count, grava os pares no MASTER e imprime os tempos.
+ * @param comm Comunicador.
+ * @param local_data Partição local de sequências.
+ * @param opts Opções de execução.
+ * @param total_start Instante de início da medição total.
+ * @return false se a gravação da saída falhou.
+ */
+bool run_kmer_count(Comm& comm, vector<string>& local_data, const Options& opts, double total_start) {
+    int rank = comm.rank();
+    KmerStats stats;
+    vector<KmerCount> counts = count_kmers(comm, local_data, opts.kmer_k, opts.canonical, &stats);
 
-    // Broadcast do número total de sequências
-    MPI_Bcast(&n, 1, MPI_INT, MASTER, MPI_COMM_WORLD);
+    // Coleta final no MASTER
+    vector<KmerCount> all_counts = gather_pod(comm, counts);
+    if (!write_on_master(comm, [&] { write_kmer_file(opts.output_filename, opts.kmer_k, all_counts); })) return false;
 
-    // Distribuição inicial das sequências
-    int local_n = n / size + (rank < (n % size) ? 1 : 0);
-    local_data.resize(local_n);
+    double total_end = comm.wtime();
 
     if (rank == MASTER) {
-        int offset = 0;
-        for (int p = 0; p < size; p++) {
-            int count = n / size + (p < (n % size) ? 1 : 0);
-            if (p == MASTER) {
-                copy(all_data.begin(), all_data.begin() + count, local_data.begin());
-            } else {
-                for (int i = 0; i < count; i++) {
-                    const string& s = all_data[offset + i];
-                    int len = s.size() + 1;
-                    MPI_Send(&len, 1, MPI_INT, p, 0, MPI_COMM_WORLD);
-                    MPI_Send(s.c_str(), len, MPI_CHAR, p, 1, MPI_COMM_WORLD);
-                }
+        cout << endl << "=== Tempos de execução ===" << endl;
+        cout << "Contagem local:       " << stats.local_count << " segundos" << endl;
+        cout << "Troca de k-mers:      " << stats.exchange << " segundos" << endl;
+        cout << "Soma das contagens:   " << stats.merge << " segundos" << endl;
+        cout << "Tempo total:          " << (total_end - total_start) << " segundos" << endl;
+        cout << "k-mers distintos:     " << all_counts.size() << endl;
+        cout << "==========================" << endl;
+    }
+    return true;
+}
+
+/**
+ * @brief Executa o modo --suffix-array e imprime os tempos.
+ * @param comm Comunicador.
+ * @param local_data Partição local de sequências.
+ * @param opts Opções de execução.
+ * @param total_start Instante de início da medição total.
+ * @return false se a gravação da saída falhou.
+ */
+bool run_suffix_array(Comm& comm, vector<string>& local_data, const Options& opts, double total_start) {
+    int rank = comm.rank();
+    int iterations;
+    double build_start = comm.wtime();
+    vector<uint64_t> local_sa = build_suffix_array(comm, local_data, &iterations);
+    double build_end = comm.wtime();
+
+    // Coleta final no MASTER
+    vector<uint64_t> suffix_array = gather_pod(comm, local_sa);
+    if (!write_on_master(comm, [&] { write_suffix_array_file(opts.output_filename, suffix_array); })) return false;
+
+    double total_end = comm.wtime();
+
+    if (rank == MASTER) {
+        cout << endl << "=== Tempos de execução ===" << endl;
+        cout << "Vetor de sufixos (" << iterations << " iterações): " << (build_end - build_start) << " segundos" << endl;
+        cout << "Tempo total:          " << (total_end - total_start) << " segundos" << endl;
+        cout << "==========================" << endl;
+    }
+    return true;
+}
+
+/**
+ * @brief Ordena as sequências com Sample Sort, grava o resultado e imprime os tempos.
+ * @param comm Comunicador.
+ * @param local_data Partição local.
+ * @param opts Opções de execução.
+ * @param total_start Instante de início da medição total.
+ * @param checkpoint Se não nulo, checkpoints das fases (removidos após a gravação da saída).
+ * @return false se a gravação da saída falhou.
+ */
+bool run_sample_sort(Comm& comm, vector<string>& local_data, const Options& opts, double total_start,
+                     SortCheckpoint* checkpoint = 0) {
+    int rank = comm.rank();
+    SortOptions sort_opts = sort_options(opts);
+    SortStats stats;
+
+    // Pivôs de uma execução anterior, lidos no MASTER (vazios se a leitura falhar) e convertidos
+    // de volta em chaves de ordenação
+    PivotHint hint;
+    if (!opts.load_splitters.empty()) {
+        if (rank == MASTER) {
+            try {
+                hint.pivots = read_splitters(opts.load_splitters);
+                encode_pivots(hint.pivots, sort_opts);
+            } catch (const exception& e) {
+                cerr << e.what() << endl;
             }
-            offset += count;
-        }
-    } else {
-        for (int i = 0; i < local_n; i++) {
-            int len;
-            MPI_Recv(&len, 1, MPI_INT, MASTER, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-            vector<char> buf(len);
-            MPI_Recv(buf.data(), len, MPI_CHAR, MASTER, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-            local_data[i] = string(buf.data());
         }
+        comm.bcast_strings(hint.pivots, MASTER);
+        hint.max_imbalance = opts.max_imbalance;
     }
 
-    // Ordenação local
-    double local_sort_start = MPI_Wtime();
-    sequential_sort(local_data);
-    double local_sort_end = MPI_Wtime();
+    vector<string> new_local = dnasort::sort(comm, local_data, sort_opts, &stats,
+                                             opts.load_splitters.empty() ? 0 : &hint, checkpoint);
+
+    // Os arquivos de pivôs e o manifesto das faixas trazem as sequências, e não as chaves
+    vector<string> pivots = stats.pivots;
+    decode_pivots(pivots, sort_opts);
 
-    // Seleção das amostras locais
-    int s = size - 1;
-    vector<string> samples;
-    for (int i = 1; i <= s; i++) {
-        int idx = i * local_data.size() / (s + 1);
-        if (idx < (int)local_data.size())
-            samples.push_back(local_data[idx]);
+    if (rank == MASTER && !opts.save_splitters.empty()) {
+        try {
+            write_splitters(opts.save_splitters, pivots);
+        } catch (const exception& e) {
+            cerr << e.what() << endl;
+        }
     }
 
-    // Coleta de amostras
-    vector<string> gathered_samples;
-    if (rank == MASTER) {
-        gathered_samples = samples;
-        for (int p = 1; p < size; p++) {
-            int count;
-            MPI_Recv(&count, 1, MPI_INT, p, 2, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-            for (int i = 0; i < count; i++) {
-                int len;
-                MPI_Recv(&len, 1, MPI_INT, p, 3, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-                vector<char> buf(len);
-                MPI_Recv(buf.data(), len, MPI_CHAR, p, 4, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-                gathered_samples.push_back(string(buf.data()));
-            }
+    progress_phase(opts.shards ? "gravação das faixas" : "coleta e gravação");
+    double write_start = comm.wtime();
+    if (opts.shards) {
+        // Cada processo grava a sua faixa; sem coleta no MASTER
+        try {
+            write_shards(comm, new_local, pivots, opts.output_filename, opts.index_block);
+            progress_advance(new_local);
+        } catch (const exception& e) {
+            if (rank == MASTER) cerr << e.what() << endl;
+            return false;
         }
-    } else {
-        int count = samples.size();
-        MPI_Send(&count, 1, MPI_INT, MASTER, 2, MPI_COMM_WORLD);
-        for (auto& smp : samples) {
-            int len = smp.size() + 1;
-            MPI_Send(&len, 1, MPI_INT, MASTER, 3, MPI_COMM_WORLD);
-            MPI_Send(smp.c_str(), len, MPI_CHAR, MASTER, 4, MPI_COMM_WORLD);
+    } else if (opts.stream_bytes > 0) {
+        // Coleta em blocos, gravados enquanto os próximos são recebidos
+        try {
+            gather_write(comm, new_local, opts.output_filename, opts.stream_bytes, opts.index_block);
+        } catch (const exception& e) {
+            if (rank == MASTER) cerr << e.what() << endl;
+            return false;
         }
+    } else {
+        // Coleta final no MASTER
+        progress_advance(new_local);
+        vector<string> final_all = comm.gather_strings(new_local, MASTER);
+
+        // Grava resultado final; em caso de erro, os checkpoints são mantidos para --resume
+        if (!write_on_master(comm, [&] { write_file(opts.output_filename, final_all, opts.index_block); })) return false;
     }
 
-    // Escolha dos pivôs globais
-    vector<string> pivots(size - 1);
+    double total_end = comm.wtime();
+
+    // Impressão dos tempos de execução
     if (rank == MASTER) {
-        sort(gathered_samples.begin(), gathered_samples.end());
-        for (int i = 1; i < size; i++) {
-            pivots[i - 1] = gathered_samples[i * gathered_samples.size() / size];
+        cout << endl << "=== Tempos de execução ===" << endl;
+        cout << "Ordenação local:      " << stats.local_sort << " segundos" << endl;
+        cout << "Ordenação final:      " << stats.final_sort << " segundos" << endl;
+        if (!opts.load_splitters.empty()) {
+            cout << "Pivôs carregados:     " << (stats.reused_pivots ? "usados" : "descartados, nova amostragem");
+            if (stats.hint_imbalance > 0) cout << " (desequilíbrio " << stats.hint_imbalance << ")" << endl;
+            else cout << " (inválidos para " << comm.size() << " processos)" << endl;
         }
+        cout << (opts.shards ? "Gravação das faixas:  " : "Coleta e gravação:    ") << (total_end - write_start) << " segundos" << endl;
+        if (checkpoint) {
+            CheckpointPhase resumed = checkpoint->resumed();
+            cout << "Checkpoints:          " << checkpoint->seconds() << " segundos"
+                 << (resumed == CheckpointPhase::EXCHANGE ? " (retomado após a troca)"
+                     : resumed == CheckpointPhase::LOCAL_SORT ? " (retomado após a ordenação local)" : "") << endl;
+        }
+        cout << "Tempo total:          " << (total_end - total_start) << " segundos" << endl;
+        cout << "==========================" << endl;
     }
 
-    // Broadcast dos pivôs
-    for (int i = 0; i < size - 1; i++) {
-        int len;
-        if (rank == MASTER) len = pivots[i].size() + 1;
-        MPI_Bcast(&len, 1, MPI_INT, MASTER, MPI_COMM_WORLD);
-        vector<char> buf(len);
-        if (rank == MASTER) strcpy(buf.data(), pivots[i].c_str());
-        MPI_Bcast(buf.data(), len, MPI_CHAR, MASTER, MPI_COMM_WORLD);
-        pivots[i] = string(buf.data());
+    // Com a saída gravada, os checkpoints não são mais necessários
+    if (checkpoint) {
+        if (allreduce(comm, (uint64_t)checkpoint->failed(), ReduceOp::MAX) && rank == MASTER) {
+            cerr << "Aviso: falha ao gravar checkpoints em " << opts.checkpoint_dir << endl;
+        }
+        checkpoint->remove();
     }
+    return true;
+}
 
-    // Particionamento das sequências locais
-    vector<vector<string>> buckets(size);
-    for (auto& seq : local_data) {
-        int pos = upper_bound(pivots.begin(), pivots.end(), seq) - pivots.begin();
-        buckets[pos].push_back(seq);
+/**
+ * @brief Descrição das opções que determinam a saída, para a chave do cache de resultados.
+ * @return Vazio nos modos que não gravam um único arquivo determinado pela entrada e quando há
+ *         outra saída além dele (--save-splitters), que um acerto no cache não gravaria.
+ */
+string result_cache_options(const Options& opts) {
+    if (opts.shards || !opts.set_filename.empty() || !opts.save_splitters.empty()) return "";
+    ostringstream desc;
+    if (opts.top_k > 0) {
+        desc << (opts.bottom ? "bottom " : "top ") << opts.top_k << " index=" << opts.index_block;
+    } else if (opts.kmer_k > 0) {
+        desc << "kmer " << opts.kmer_k;
+    } else if (opts.suffix_array) {
+        desc << "suffix-array";
+    } else if (opts.segments) {
+        desc << "segments delimiter=" << (int)opts.delimiter;
+        if (opts.key_prefix > 0) desc << " prefix=" << opts.key_prefix;
+    } else if (!opts.ranks.empty() || !opts.quantiles.empty()) {
+        desc << "ranks";
+        for (long long r : opts.ranks) desc << " " << r;
+        desc << " quantiles";
+        for (double q : opts.quantiles) desc << " " << q;
+    } else {
+        return sort_cache_options(sort_options(opts), opts.index_block);
     }
+    desc << " canonical=" << opts.canonical;
+    if (opts.collation != Collation::LEXICOGRAPHIC) desc << " order=" << collation_name(sort_options(opts));
+    return desc.str();
+}
 
-    // Troca de dados entre processos
-    vector<int> send_sizes(size), recv_sizes(size);
-    for (int i = 0; i < size; i++) send_sizes[i] = buckets[i].size();
-    MPI_Alltoall(send_sizes.data(), 1, MPI_INT, recv_sizes.data(), 1, MPI_INT, MPI_COMM_WORLD);
+/**
+ * @brief Etiqueta dos checkpoints: identifica a entrada (nome, tamanho e modificação) e as opções.
+ */
+string checkpoint_tag(const Options& opts) {
+    struct stat st;
+    ostringstream tag;
+    tag << "input=" << opts.input_filename;
+    if (stat(opts.input_filename.c_str(), &st) == 0) tag << " bytes=" << st.st_size << " mtime=" << st.st_mtime;
+    tag << " canonical=" << opts.canonical << " order=" << collation_name(sort_options(opts))
+        << " key=" << opts.key_field << " delimiter=" << (int)opts.delimiter;
+    return tag.str();
+}
 
-    vector<string> new_local;
-    for (int p = 0; p < size; p++) {
-        if (p == rank) {
-            new_local.insert(new_local.end(), buckets[p].begin(), buckets[p].end());
-        } else {
-            for (auto& smp : buckets[p]) {
-                int len = smp.size() + 1;
-                MPI_Send(&len, 1, MPI_INT, p, 5, MPI_COMM_WORLD);
-                MPI_Send(smp.c_str(), len, MPI_CHAR, p, 6, MPI_COMM_WORLD);
-            }
+/**
+ * @brief Executa --join, --intersect ou --subtract entre a entrada e o arquivo B, grava o
+ *        resultado e imprime os tempos.
+ * @param comm Comunicador.
+ * @param local_data Partição local da entrada.
+ * @param opts Opções de execução.
+ * @param total_start Instante de início da medição total.
+ * @return false se o arquivo B não pôde ser lido ou se a gravação da saída falhou.
+ */
+bool run_set_operation(Comm& comm, vector<string>& local_data, const Options& opts, double total_start) {
+    int rank = comm.rank();
+    vector<string> all_b;
+    int n = 0;
+
+    // Leitura de B apenas no MASTER (n = -1 indica erro de leitura)
+    if (rank == MASTER) {
+        try {
+            all_b = read_file(opts.set_filename);
+            n = all_b.size();
+        } catch (const exception& e) {
+            cerr << e.what() << endl;
+            n = -1;
         }
     }
-    for (int p = 0; p < size; p++) {
-        if (p != rank) {
-            for (int i = 0; i < recv_sizes[p]; i++) {
-                int len;
-                MPI_Recv(&len, 1, MPI_INT, p, 5, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-                vector<char> buf(len);
-                MPI_Recv(buf.data(), len, MPI_CHAR, p, 6, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-                new_local.push_back(string(buf.data()));
+    comm.bcast(&n, sizeof(n), MASTER);
+    if (n < 0) return false;
+    vector<string> local_b = distribute_sequences(comm, all_b, n);
+
+    SortStats stats;
+    double op_start = comm.wtime();
+    vector<string> local_result = set_operation(comm, local_data, local_b, opts.set_op, &stats);
+    double op_end = comm.wtime();
+
+    // Coleta final no MASTER
+    vector<string> result = comm.gather_strings(local_result, MASTER);
+    if (!write_on_master(comm, [&] { write_file(opts.output_filename, result, opts.index_block); })) return false;
+
+    double total_end = comm.wtime();
+
+    if (rank == MASTER) {
+        cout << endl << "=== Tempos de execução ===" << endl;
+        cout << "Ordenação local:      " << stats.local_sort << " segundos" << endl;
+        cout << "Ordenação final:      " << stats.final_sort << " segundos" << endl;
+        cout << "Operação (total):     " << (op_end - op_start) << " segundos" << endl;
+        cout << "Tempo total:          " << (total_end - total_start) << " segundos" << endl;
+        cout << "Linhas gravadas:      " << result.size() << endl;
+        cout << "==========================" << endl;
+    }
+    return true;
+}
+
+/**
+ * @brief Lê a entrada no MASTER, distribui as sequências e executa o modo escolhido.
+ * @param comm Comunicador.
+ * @param opts Opções de execução.
+ * @param preloaded Se não nulo (no MASTER), entrada já lida; é esvaziada.
+ * @return 0 em caso de sucesso, 1 em erro.
+ */
+int run(Comm& comm, const Options& opts, vector<string>* preloaded = 0) {
+    int rank = comm.rank();
+    vector<string> all_data;
+    int n = 0;
+
+    // Cache (no MASTER): a mesma entrada com as mesmas opções reaproveita a saída anterior
+    unique_ptr<ResultCache> cache;
+    string cache_key, cache_options = result_cache_options(opts);
+    if (!opts.cache_dir.empty() && !cache_options.empty()) {
+        double cache_start = comm.wtime();
+        uint64_t hit = 0;
+        if (rank == MASTER) {
+            try {
+                cache.reset(new ResultCache(opts.cache_dir, opts.cache_max_bytes));
+                cache_key = ResultCache::key(opts.input_filename, cache_options, opts.threads);
+                hit = cache->fetch(cache_key, opts.output_filename, opts.index_block > 0, opts.threads);
+            } catch (const exception& e) {
+                cerr << e.what() << endl;
+                cache.reset();
             }
         }
+        comm.bcast(&hit, sizeof(hit), MASTER);
+        if (hit) {
+            if (rank == MASTER) cout << "Resultado obtido do cache em " << (comm.wtime() - cache_start) << " segundos" << endl;
+            return 0;
+        }
     }
 
-    // Ordenação final local
-    double final_sort_start = MPI_Wtime();
-    sequential_sort(new_local);
-    double final_sort_end = MPI_Wtime();
-
-    // Coleta final no MASTER
-    int final_local_n = new_local.size();
-    vector<int> final_counts(size);
-    MPI_Gather(&final_local_n, 1, MPI_INT, final_counts.data(), 1, MPI_INT, MASTER, MPI_COMM_WORLD);
+    // Checkpoints: com --resume, as fases salvas por todos os ranks dispensam a leitura da entrada
+    unique_ptr<SortCheckpoint> checkpoint;
+    if (!opts.checkpoint_dir.empty()) {
+        vector<string> tag(1);
+        if (rank == MASTER) tag[0] = checkpoint_tag(opts);
+        comm.bcast_strings(tag, MASTER);
+        checkpoint.reset(new SortCheckpoint(comm, opts.checkpoint_dir, tag[0]));
+        if (opts.resume) checkpoint->find_resume_phase(comm);
+    }
+    bool resumed = checkpoint && checkpoint->resumed() != CheckpointPhase::NONE;
 
-    vector<string> final_all;
+    // Leitura inicial apenas no processo MASTER (n = -1 indica erro de leitura)
+    progress_phase("leitura");
     if (rank == MASTER) {
-        int total = accumulate(final_counts.begin(), final_counts.end(), 0);
-        final_all.reserve(total);
-
-        final_all.insert(final_all.end(), new_local.begin(), new_local.end());
-        for (int p = 1; p < size; p++) {
-            for (int i = 0; i < final_counts[p]; i++) {
-                int len;
-                MPI_Recv(&len, 1, MPI_INT, p, 7, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-                vector<char> buf(len);
-                MPI_Recv(buf.data(), len, MPI_CHAR, p, 8, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-                final_all.push_back(string(buf.data()));
+        try {
+            if (preloaded) all_data.swap(*preloaded);
+            if (resumed) vector<string>().swap(all_data);
+            else if (!preloaded) all_data = read_file(opts.input_filename);
+            n = all_data.size();
+            progress_advance(all_data);
+
+            // Trabalho total da ordenação completa, para a estimativa de término do progresso
+            Progress* progress = current_progress();
+            struct stat st;
+            bool full_sort = opts.set_filename.empty() && opts.top_k == 0 && opts.kmer_k == 0 && !opts.suffix_array &&
+                             opts.ranks.empty() && opts.quantiles.empty();
+            if (progress && full_sort && !resumed && stat(opts.input_filename.c_str(), &st) == 0) {
+                progress->set_total((uint64_t)st.st_size * SORT_PROGRESS_PASSES);
             }
+        } catch (const exception& e) {
+            cerr << e.what() << endl;
+            n = -1;
         }
+    }
+
+    double total_start = comm.wtime();
 
-        // Grava resultado final
-        write_file(argv[2], final_all);
+    // Broadcast do número total de sequências
+    comm.bcast(&n, sizeof(n), MASTER);
+    if (n < 0) return 1;
+
+    // Distribuição inicial das sequências
+    progress_phase("distribuição");
+    vector<string> local_data = distribute_sequences(comm, all_data, n);
+    progress_advance(local_data);
+
+    int status = 0;
+    if (!opts.set_filename.empty()) {
+        progress_phase("operação entre arquivos");
+        if (!run_set_operation(comm, local_data, opts, total_start)) status = 1;
+    } else if (opts.top_k > 0) {
+        progress_phase("seleção");
+        if (!run_top_k(comm, local_data, opts, total_start)) status = 1;
+    } else if (opts.segments) {
+        if (!run_segmented_sort(comm, local_data, opts, total_start)) status = 1;
+    } else if (opts.kmer_k > 0) {
+        progress_phase("contagem de k-mers");
+        if (!run_kmer_count(comm, local_data, opts, total_start)) status = 1;
+    } else if (opts.suffix_array) {
+        progress_phase("vetor de sufixos");
+        if (!run_suffix_array(comm, local_data, opts, total_start)) status = 1;
+    } else if (!opts.ranks.empty() || !opts.quantiles.empty()) {
+        progress_phase("seleção por posição");
+        if (!run_select_ranks(comm, local_data, opts, n, total_start)) status = 1;
     } else {
-        for (auto& s : new_local) {
-            int len = s.size() + 1;
-            MPI_Send(&len, 1, MPI_INT, MASTER, 7, MPI_COMM_WORLD);
-            MPI_Send(s.c_str(), len, MPI_CHAR, MASTER, 8, MPI_COMM_WORLD);
-        }
+        if (!run_sample_sort(comm, local_data, opts, total_start, checkpoint.get())) status = 1;
     }
+    if (status == 0 && cache) cache->store(cache_key, opts.output_filename, opts.index_block > 0, opts.threads);
+    return status;
+}
 
-    double total_end = MPI_Wtime();
+/**
+ * @brief Executa o modo --merge e imprime os tempos.
+ * @param comm Comunicador.
+ * @param opts Opções de execução.
+ * @return 0 em caso de sucesso, 1 em erro.
+ */
+int run_merge(Comm& comm, const Options& opts) {
+    int rank = comm.rank();
+    double total_start = comm.wtime();
+    MergeStats stats;
+    progress_phase("intercalação");
+    try {
+        merge_sorted_files(comm, opts.merge_inputs, opts.output_filename, &stats);
+        if (rank == MASTER && opts.index_block > 0) build_index(opts.output_filename, opts.index_block);
+    } catch (const exception& e) {
+        if (rank == MASTER) cerr << e.what() << endl;
+        return 1;
+    }
+    double total_end = comm.wtime();
 
-    // Impressão dos tempos de execução
     if (rank == MASTER) {
         cout << endl << "=== Tempos de execução ===" << endl;
-        cout << "Ordenação local:      " << (local_sort_end - local_sort_start) << " segundos" << endl;
-        cout << "Ordenação final:      " << (final_sort_end - final_sort_start) << " segundos" << endl;
+        cout << "Busca das fronteiras: " << stats.splitters << " segundos" << endl;
+        cout << "Intercalação/escrita: " << stats.merge << " segundos" << endl;
         cout << "Tempo total:          " << (total_end - total_start) << " segundos" << endl;
+        cout << "Bytes gravados:       " << stats.bytes << endl;
         cout << "==========================" << endl;
     }
+    return 0;
+}
 
-    MPI_Finalize();
+/**
+ * @brief Lê o manifesto do modo lote.
+ *
+ * Cada linha contém "<arquivo_entrada> <arquivo_saida>"; linhas vazias ou iniciadas por '#'
+ * são ignoradas.
+ *
+ * @param filename Nome do arquivo de manifesto.
+ * @return Pares (entrada, saída) concatenados: entrada 0, saída 0, entrada 1, ...
+ */
+vector<string> read_manifest(const string& filename) {
+    ifstream file(filename);
+    if (!file.is_open()) {throw runtime_error("Erro ao abrir o manifesto: " + filename);}
+
+    vector<string> files;
+    string line;
+    while (getline(file, line)) {
+        istringstream fields(line);
+        string input, output, extra;
+        if (!(fields >> input) || input[0] == '#') continue;
+        if (!(fields >> output) || (fields >> extra)) {throw runtime_error("Linha inválida no manifesto: " + line);}
+        files.push_back(input);
+        files.push_back(output);
+    }
+    return files;
+}
+
+/**
+ * @brief Modo lote: executa o modo escolhido para cada par (entrada, saída) do manifesto.
+ *
+ * Enquanto um arquivo é distribuído, trocado e ordenado, o MASTER já lê o próximo em uma
+ * thread separada, sobrepondo a leitura ao processamento. Ao final imprime a vazão agregada.
+ *
+ * @param comm Comunicador.
+ * @param opts Opções de execução (aplicadas a todos os arquivos).
+ * @return 0 se todos os arquivos foram processados, 1 caso contrário.
+ */
+int run_manifest(Comm& comm, const Options& opts) {
+    int rank = comm.rank();
+    vector<string> files;
+    int count = 0;
+    if (rank == MASTER) {
+        try {
+            files = read_manifest(opts.manifest);
+            count = files.size() / 2;
+        } catch (const exception& e) {
+            cerr << e.what() << endl;
+            count = -1;
+        }
+    }
+    comm.bcast(&count, sizeof(count), MASTER);
+    if (count < 0) return 1;
+    comm.bcast_strings(files, MASTER);
+
+    double batch_start = comm.wtime();
+    long long sequences = 0, bytes = 0;
+    int failed = 0;
+
+    // Leitura antecipada do próximo arquivo no MASTER
+    future<vector<string>> next;
+    if (rank == MASTER && count > 0) next = async(launch::async, read_file, files[0]);
+
+    for (int i = 0; i < count; i++) {
+        Options job_opts = opts;
+        job_opts.manifest.clear();
+        job_opts.input_filename = files[2 * i];
+        job_opts.output_filename = files[2 * i + 1];
+
+        vector<string> data;
+        bool loaded = false;
+        if (rank == MASTER) {
+            // Em caso de erro, run repete a leitura e reporta a falha a todos os processos
+            try {
+                data = next.get();
+                loaded = true;
+            } catch (const exception&) {}
+            if (i + 1 < count) next = async(launch::async, read_file, files[2 * (i + 1)]);
+            for (const auto& seq : data) bytes += seq.size() + 1;
+            sequences += data.size();
+            cout << endl << "[" << (i + 1) << "/" << count << "] " << job_opts.input_filename << endl;
+        }
+        if (run(comm, job_opts, loaded ? &data : 0) != 0) failed++;
+    }
+    double batch_end = comm.wtime();
+
+    if (rank == MASTER) {
+        double seconds = batch_end - batch_start;
+        cout << endl << "=== Lote ===" << endl;
+        cout << "Arquivos:             " << count << " (" << failed << " com erro)" << endl;
+        cout << "Sequências:           " << sequences << endl;
+        cout << "Tempo total:          " << seconds << " segundos" << endl;
+        if (seconds > 0) {
+            cout << "Vazão:                " << (sequences / seconds) << " sequências/s, "
+                 << (bytes / seconds / (1024.0 * 1024.0)) << " MB/s" << endl;
+        }
+        cout << "============" << endl;
+    }
+    return failed > 0 ? 1 : 0;
+}
+
+/**
+ * @brief Modo serviço: os processos permanecem ativos e executam os jobs da fila em dir.
+ *
+ * Os processos são divididos em opts.groups grupos de ranks contíguos; o líder de cada grupo
+ * reivindica jobs da fila e os difunde para o seu grupo, de modo que até opts.groups jobs
+ * executam ao mesmo tempo. O tempo de cada job é gravado no arquivo de resultado.
+ *
+ * @param world Comunicador de todos os processos.
+ * @param opts Opções do serviço.
+ * @return 0 ao encerrar com o arquivo STOP, 1 em erro de configuração.
+ */
+int run_daemon(Comm& world, const Options& opts) {
+    if (opts.groups > world.size()) {
+        if (world.rank() == MASTER) cerr << "--groups maior que o número de processos" << endl;
+        return 1;
+    }
+    int group_id = world.rank() * opts.groups / world.size();
+    unique_ptr<Comm> group = world.split(group_id, world.rank());
+    bool leader = (group->rank() == MASTER);
+    if (world.rank() == MASTER) {
+        cout << "Serviço ativo em " << opts.daemon_dir << " com " << opts.groups << " grupo(s)" << endl;
+    }
+
+    while (true) {
+        // Comando do líder: 0 = fila vazia, 1 = job, 2 = encerrar
+        int command = 0;
+        Job job;
+        if (leader) {
+            if (stop_requested(opts.daemon_dir)) {
+                command = 2;
+            } else if (claim_job(opts.daemon_dir, job)) {
+                command = 1;
+                if (!job.error.empty()) {
+                    finish_job(opts.daemon_dir, job, false, "status=failed\nerror=" + job.error + "\n");
+                    command = 0;
+                }
+            } else {
+                this_thread::sleep_for(chrono::milliseconds(DAEMON_POLL_MS));
+            }
+        }
+        group->bcast(&command, sizeof(command), MASTER);
+        if (command == 2) break;
+        if (command == 0) continue;
+
+        vector<string> args = job.args;
+        group->bcast_strings(args, MASTER);
+
+        double start = group->wtime();
+        Options job_opts;
+        bool ok = parse_options(args, job_opts) && job_opts.daemon_dir.empty() && job_opts.manifest.empty()
+                  && job_opts.threads == 0;
+        string error = ok ? "" : "opções inválidas";
+        if (ok) {
+            try {
+                ok = (run(*group, job_opts) == 0);
+                if (!ok) error = "falha na execução";
+            } catch (const exception& e) {
+                ok = false;
+                error = e.what();
+            }
+        }
+        double end = group->wtime();
+
+        if (leader) {
+            ostringstream report;
+            report << "status=" << (ok ? "ok" : "failed") << "\n"
+                   << "group=" << group_id << "\n"
+                   << "processes=" << group->size() << "\n"
+                   << "seconds=" << (end - start) << "\n";
+            if (!ok) report << "error=" << error << "\n";
+            finish_job(opts.daemon_dir, job, ok, report.str());
+        }
+    }
     return 0;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Executa um arquivo, o modo lote ou o modo serviço, conforme as opções.
+ */
+int run_mode(Comm& comm, const Options& opts) {
+    // Progresso: cada rank tem os seus contadores e a sua thread de relatório
+    unique_ptr<Progress> progress;
+    unique_ptr<ProgressReporter> reporter;
+    if (opts.progress_seconds > 0) {
+        progress.reset(new Progress());
+        set_current_progress(progress.get());
+        reporter.reset(new ProgressReporter(comm.rank(), comm.size(), *progress, opts.status_file, opts.progress_seconds));
+    }
+
+    int status;
+    if (!opts.daemon_dir.empty()) status = run_daemon(comm, opts);
+    else if (!opts.manifest.empty()) status = run_manifest(comm, opts);
+    else if (!opts.merge_inputs.empty()) status = run_merge(comm, opts);
+    else status = run(comm, opts);
+
+    // Estado final de todos os ranks no arquivo de estado; os arquivos por rank são removidos
+    if (reporter) {
+        progress->phase(status == 0 ? "concluído" : "falhou");
+        reporter->stop();
+        comm.barrier();
+        if (comm.rank() == MASTER) reporter->summarize(true);
+        comm.barrier();
+        reporter->remove();
+        set_current_progress(0);
+    }
+    return status;
+}
+
+/**
+ * @brief Função principal. Ordena sequências de DNA paralelamente usando Sample Sort com MPI
+ *        ou, com --threads (ou quando compilado com DNASORT_NO_MPI), com threads.
+ * @param argc Número de argumentos.
+ * @param argv Vetor de argumentos (entrada, saída e opções).
+ * @return 0 em caso de sucesso, 1 em erro.
+ */
+int main(int argc, char** argv) {
+    int rank = MASTER;
+#ifndef DNASORT_NO_MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+    Options opts;
+    if (!parse_options(vector<string>(argv + 1, argv + argc), opts)) {
+        if (rank == MASTER) { cerr << "Formato de execução: mpirun -np <N> " << argv[0] << " (<arquivo_entrada> <arquivo_saida> | --merge a1,a2,... <arquivo_saida> | --manifest <arquivo> | --daemon <diretório> [--groups G]) [--threads N] [--canonical] [--order O] [--key-field N [--delimiter C] | --key-prefix K] [--shards | --stream MB] [--save-splitters ARQ] [--load-splitters ARQ [--max-imbalance X]] [--checkpoint DIR [--resume]] [--cache-dir DIR [--cache-max-mb N]] [--progress S [--status-file ARQ]] [--index B] [--join B | --intersect B | --subtract B | --top K | --bottom K | --ranks r1,r2,... | --quantiles q1,q2,... | --segments | --kmer-count K | --suffix-array]\n"; }
+#ifndef DNASORT_NO_MPI
+        MPI_Finalize();
+#endif
+        return 1;
+    }
+
+    int status = 0;
+#ifdef DNASORT_NO_MPI
+    if (opts.threads == 0) opts.threads = max(1u, thread::hardware_concurrency());
+#endif
+    if (opts.threads > 0) {
+        // Cada processo executa o algoritmo completo com os seus próprios ranks-thread
+        run_threads(opts.threads, [&](Comm& comm) {
+            int thread_status = run_mode(comm, opts);
+            if (comm.rank() == MASTER) status = thread_status;
+        });
+    } else {
+#ifndef DNASORT_NO_MPI
+        MpiComm world(MPI_COMM_WORLD);
+        status = run_mode(world, opts);
+#endif
+    }
+
+#ifndef DNASORT_NO_MPI
+    MPI_Finalize();
+#endif
+    return status;
+}
@@ -0,0 +1,204 @@
+/**
+ * @file SegmentedSort.cpp
+ * @brief Implementação da ordenação segmentada, local e distribuída.
+ */
+
+#include "SegmentedSort.h"
+#include "Progress.h"
+#include "ThreadComm.h"
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <thread>
+#include <utility>
+
+using namespace std;
+
+namespace dnasort {
+
+#define SMALL_SEGMENT 16     ///< Segmentos até este tamanho são ordenados por inserção.
+#define LARGE_SEGMENT 65536  ///< Segmentos a partir deste tamanho usam o Sample Sort com todas as threads.
+
+Segments group_segments(vector<string>& ids, vector<string>& data) {
+    vector<size_t> order(ids.size());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return ids[a] < ids[b]; });
+
+    Segments segs;
+    segs.data.resize(data.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        size_t j = order[i];
+        if (segs.ids.empty() || ids[j] != segs.ids.back()) {
+            segs.ids.push_back(move(ids[j]));
+            segs.offsets.push_back(i);
+        }
+        segs.data[i].swap(data[j]);
+    }
+    segs.offsets.push_back(order.size());
+    vector<string>().swap(ids);
+    vector<string>().swap(data);
+    return segs;
+}
+
+/**
+ * @brief Ordenação por inserção de [first, last) com a ordem less (estável).
+ */
+template <typename Less>
+static void insertion_sort(string* first, string* last, Less less) {
+    for (string* it = first + 1; it < last; ++it) {
+        string value(move(*it));
+        string* pos = it;
+        for (; pos > first && less(value, *(pos - 1)); --pos) *pos = move(*(pos - 1));
+        *pos = move(value);
+    }
+}
+
+/**
+ * @brief Ordena um segmento; os pequenos por inserção, sem o vetor auxiliar de sort.
+ */
+static void sort_segment(string* first, string* last, const SortOptions& opts) {
+    if (last - first < 2) return;
+    if (last - first > SMALL_SEGMENT) {
+        sort(first, last, opts);
+        return;
+    }
+    to_sort_keys(first, last, opts);
+    if (opts.key_prefix > 0) {
+        insertion_sort(first, last, [&](const string& a, const string& b) {
+            return prefix_key(a, opts) < prefix_key(b, opts);
+        });
+    } else if (opts.key_field > 0) {
+        insertion_sort(first, last, RecordLess(opts));
+    } else {
+        insertion_sort(first, last, less<string>());
+    }
+    from_sort_keys(first, last, opts);
+}
+
+void segmented_sort(vector<string>& data, const vector<size_t>& offsets, const SortOptions& opts, int threads) {
+    if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+    size_t segments = offsets.empty() ? 0 : offsets.size() - 1;
+    auto length = [&](size_t s) { return offsets[s + 1] - offsets[s]; };
+    auto is_large = [&](size_t s) { return threads > 1 && length(s) >= LARGE_SEGMENT; };
+
+    // Lotes contíguos de segmentos com quantidades parecidas de sequências, um por thread
+    size_t small_total = 0;
+    vector<size_t> large;
+    for (size_t s = 0; s < segments; s++) {
+        if (is_large(s)) large.push_back(s);
+        else small_total += length(s);
+    }
+    vector<size_t> bounds(threads + 1, segments);
+    bounds[0] = 0;
+    size_t seen = 0;
+    int next = 1;
+    for (size_t s = 0; s < segments && next < threads; s++) {
+        if (!is_large(s)) seen += length(s);
+        while (next < threads && seen >= small_total * next / threads) bounds[next++] = s + 1;
+    }
+
+    auto sort_batch = [&](int t) {
+        for (size_t s = bounds[t]; s < bounds[t + 1]; s++) {
+            if (!is_large(s)) sort_segment(data.data() + offsets[s], data.data() + offsets[s + 1], opts);
+        }
+    };
+    vector<thread> workers;
+    for (int t = 1; t < threads; t++) workers.emplace_back(sort_batch, t);
+    sort_batch(0);
+    for (auto& worker : workers) worker.join();
+
+    // Segmentos grandes: Sample Sort com uma partição contígua do segmento por thread
+    for (size_t s : large) {
+        size_t begin = offsets[s], len = length(s);
+        vector<vector<string>> parts(threads);
+        run_threads(threads, [&](Comm& comm) {
+            int p = comm.rank();
+            vector<string> local(make_move_iterator(data.begin() + begin + p * len / threads),
+                                 make_move_iterator(data.begin() + begin + (p + 1) * len / threads));
+            parts[p] = sort(comm, local, opts);
+        });
+        size_t pos = begin;
+        for (auto& part : parts) {
+            for (auto& seq : part) data[pos++].swap(seq);
+        }
+    }
+}
+
+Segments sort_segments(Comm& comm, vector<string>& ids, vector<string>& data, const SortOptions& opts,
+                       int threads, SortStats* stats) {
+    int rank = comm.rank(), size = comm.size();
+
+    progress_phase("agrupamento");
+    double group_start = comm.wtime();
+    Segments local = group_segments(ids, data);
+    double group_end = comm.wtime();
+    progress_advance(local.data);
+
+    // Amostras: identificadores nas posições regulares das sequências agrupadas
+    progress_phase("amostragem");
+    vector<string> samples;
+    size_t n = local.data.size();
+    for (int i = 1; i < size && n > 0; i++) {
+        size_t pos = i * n / size;
+        size_t s = upper_bound(local.offsets.begin(), local.offsets.end(), pos) - local.offsets.begin() - 1;
+        samples.push_back(local.ids[s]);
+    }
+    vector<string> gathered_samples = comm.gather_strings(samples, MASTER);
+    vector<string> pivots(size - 1);
+    if (rank == MASTER) pivots = choose_pivots(gathered_samples, size);
+    comm.bcast_strings(pivots, MASTER);
+
+    // Troca por faixas de identificadores: segmentos inteiros, com os seus tamanhos
+    progress_phase("troca");
+    vector<size_t> segment_counts(size), record_counts(size);
+    size_t begin = 0;
+    for (int p = 0; p < size; p++) {
+        size_t end = (p < size - 1)
+            ? upper_bound(local.ids.begin() + begin, local.ids.end(), pivots[p]) - local.ids.begin()
+            : local.ids.size();
+        segment_counts[p] = end - begin;
+        record_counts[p] = local.offsets[end] - local.offsets[begin];
+        begin = end;
+    }
+    vector<uint64_t> lengths(local.ids.size());
+    for (size_t s = 0; s < lengths.size(); s++) lengths[s] = local.offsets[s + 1] - local.offsets[s];
+    vector<uint64_t> recv_lengths = alltoallv_pod(comm, lengths, segment_counts);
+    vector<string> recv_ids = comm.alltoallv_strings(local.ids, segment_counts);
+    vector<string> recv_data = comm.alltoallv_strings(local.data, record_counts);
+    local = Segments();
+    progress_advance(recv_data);
+
+    // Partes de um mesmo segmento (uma por rank de origem) são concatenadas em ordem de rank
+    vector<size_t> starts(recv_ids.size());
+    for (size_t i = 1; i < starts.size(); i++) starts[i] = starts[i - 1] + recv_lengths[i - 1];
+    vector<size_t> order(recv_ids.size());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return recv_ids[a] < recv_ids[b]; });
+
+    Segments result;
+    result.data.resize(recv_data.size());
+    size_t pos = 0;
+    for (size_t i : order) {
+        if (result.ids.empty() || recv_ids[i] != result.ids.back()) {
+            result.ids.push_back(move(recv_ids[i]));
+            result.offsets.push_back(pos);
+        }
+        for (uint64_t k = 0; k < recv_lengths[i]; k++) result.data[pos++].swap(recv_data[starts[i] + k]);
+    }
+    result.offsets.push_back(pos);
+
+    progress_phase("ordenação dos segmentos");
+    double sort_start = comm.wtime();
+    segmented_sort(result.data, result.offsets, opts, threads);
+    double sort_end = comm.wtime();
+    progress_advance(result.data);
+
+    if (stats) {
+        stats->local_sort = group_end - group_start;
+        stats->final_sort = sort_end - sort_start;
+    }
+    return result;
+}
+
+} // namespace dnasort
@@ -0,0 +1,89 @@
+/**
+ * @file SegmentedSort.h
+ * @brief Ordenação segmentada: ordena as sequências dentro de cada grupo, sem ordem global.
+ *
+ * Cada segmento (um código de barras, uma faixa do genoma) é ordenado de forma independente.
+ * Em vez de uma chamada a sequential_sort por segmento, uma única chamada distribui os
+ * segmentos entre threads em lotes contíguos de tamanho parecido. Os segmentos pequenos são
+ * ordenados por inserção, sem alocação, e os grandes passam pelo Sample Sort com threads
+ * (ThreadComm), usando todas as threads. Na versão distribuída, cada segmento fica inteiro em
+ * um único rank.
+ *
+ * Exemplo de uso:
+ *   dnasort::Segments segs = dnasort::group_segments(barcodes, reads);
+ *   dnasort::segmented_sort(segs.data, segs.offsets, dnasort::SortOptions(), 8);
+ */
+
+#ifndef SEGMENTED_SORT_H
+#define SEGMENTED_SORT_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Comm.h"
+#include "DnaSort.h"
+#include "ParallelSort.h"
+
+namespace dnasort {
+
+/**
+ * @brief Sequências agrupadas em segmentos contíguos.
+ */
+struct Segments {
+    std::vector<std::string> ids;      ///< Identificador de cada segmento, em ordem crescente de bytes.
+    std::vector<std::size_t> offsets;  ///< Início de cada segmento em data, seguido do fim (ids.size() + 1 valores).
+    std::vector<std::string> data;     ///< Sequências, um segmento após o outro.
+};
+
+/**
+ * @brief Agrupa as sequências pelo identificador do segmento.
+ *
+ * Dentro de cada segmento, as sequências mantêm a ordem da entrada.
+ *
+ * @param ids Identificador do segmento de cada sequência (é esvaziado).
+ * @param data Sequências (é esvaziado).
+ * @return Segmentos em ordem crescente de identificador.
+ */
+Segments group_segments(std::vector<std::string>& ids, std::vector<std::string>& data);
+
+/**
+ * @brief Ordena cada segmento [offsets[i], offsets[i + 1]) de data na ordem de opts.
+ *
+ * Os segmentos com até 16 sequências são ordenados por inserção. Com mais de uma thread, os
+ * segmentos com pelo menos 65536 sequências são ordenados um de cada vez pelo Sample Sort com
+ * threads threads, e os demais são divididos entre as threads.
+ *
+ * @param data Sequências, segmento após segmento.
+ * @param offsets Início de cada segmento, seguido do fim do último.
+ * @param opts Ordem dentro dos segmentos.
+ * @param threads Número de threads (0 usa std::thread::hardware_concurrency()).
+ */
+void segmented_sort(std::vector<std::string>& data, const std::vector<std::size_t>& offsets,
+                    const SortOptions& opts = SortOptions(), int threads = 1);
+
+/**
+ * @brief Ordenação segmentada distribuída.
+ *
+ * Cada rank agrupa as suas sequências e envia ao MASTER size - 1 identificadores amostrados
+ * na ordem dos grupos, de modo que os segmentos grandes pesam mais na escolha dos pivôs. As
+ * faixas de identificadores delimitadas pelos pivôs vão, inteiras, para um único rank, onde as
+ * partes de um mesmo segmento vindas de ranks diferentes são concatenadas em ordem de rank e
+ * ordenadas com segmented_sort. Um segmento maior que n / size não é dividido, e o seu rank
+ * fica com mais trabalho.
+ *
+ * @param comm Comunicador dos processos participantes.
+ * @param ids Identificador do segmento de cada sequência local (é esvaziado).
+ * @param data Sequências locais (é esvaziado).
+ * @param opts Ordem dentro dos segmentos.
+ * @param threads Threads de segmented_sort em cada rank.
+ * @param stats Se não nulo, recebe o tempo do agrupamento local (local_sort) e da ordenação
+ *              dos segmentos (final_sort).
+ * @return Segmentos locais ordenados; os identificadores estão em ordem crescente de rank.
+ */
+Segments sort_segments(Comm& comm, std::vector<std::string>& ids, std::vector<std::string>& data,
+                       const SortOptions& opts = SortOptions(), int threads = 1, SortStats* stats = 0);
+
+} // namespace dnasort
+
+#endif // SEGMENTED_SORT_H
@@ -3,82 +3,93 @@
  * @brief Programa para ordenação sequencial de sequências de DNA lidas de um arquivo.
  *
  * Este programa lê sequências de DNA de um arquivo texto, armazena-as em um vetor de strings,
- * ordena as sequências em ordem lexicográfica utilizando sort da biblioteca padrão C++,
+ * ordena as sequências em ordem lexicográfica (ou na ordem de --order) utilizando sort da biblioteca padrão C++,
  * e grava o resultado ordenado em um arquivo de saída. O tempo de execução da ordenação é medido e exibido ao usuário.
  *
- * Funções principais:
- * - sequential_sort: Ordena um vetor de sequências de DNA utilizando sort.
- * - read_file: Lê um arquivo texto contendo sequências de DNA (uma por linha) e armazena-as em um vetor de strings.
- * - write_file: Escreve as sequências ordenadas em um arquivo texto, uma por linha.
+ * A leitura, a escrita e a ordenação estão na biblioteca (DnaSort.h).
  *
  * Execução:
- *   ./SequencialSort <arquivo_entrada> <arquivo_saida>
+ *   ./SequencialSort <arquivo_entrada> <arquivo_saida> [--canonical] [--order O | --key-field N [--delimiter C] | --key-prefix K | --index B] [--cache-dir DIR [--cache-max-mb N]]
  *
  * Argumentos:
  *   arquivo_entrada - Caminho para o arquivo contendo as sequências de DNA a serem ordenadas.
  *   arquivo_saida   - Caminho para o arquivo onde as sequências ordenadas serão gravadas.
+ *   --canonical     - Ordena cada sequência pela sua forma canônica (sequência ou reverso complementar).
+ *   --order O       - Ordem das sequências: lex (padrão), length (tamanho e depois lexicográfica),
+ *                     reverse (lexicográfica inversa) ou uma permutação de ACGT com a ordem das
+ *                     bases, por exemplo ACTG (ver Collation.h).
+ *   --key-field N   - Ordena registros delimitados (TSV, CSV) pelo campo N (base 1); com chaves
+ *                     iguais, pelo registro inteiro. --delimiter C define o separador (padrão tab).
+ *   --key-prefix K  - Ordena apenas pelas primeiras K bases (1 <= K <= 21), mantendo a ordem da
+ *                     entrada entre sequências de mesmo prefixo.
+ *   --index B       - Grava também o índice esparso "<arquivo_saida>.idx" com blocos de B linhas.
+ *   --cache-dir DIR - Reaproveita a saída de uma execução anterior sobre a mesma entrada e opções
+ *                     (ver ResultCache.h); --cache-max-mb limita o tamanho do cache (padrão 1024).
  *
  */
 
 #include <iostream>
-#include <fstream>
 #include <vector>
 #include <string>
-#include <algorithm>
 #include <chrono>
+#include <cstdlib>
+#include <memory>
 
-using namespace std;
-
-/**
- * @brief Ordena um vetor de sequências de DNA em ordem lexicográfica.
- * @param data Vetor de strings representando sequências de DNA.
- */
-void sequential_sort(vector<string>& data) {
-    sort(data.begin(), data.end());
-}
+#include "DnaSort.h"
+#include "Collation.h"
+#include "ResultCache.h"
 
-/**
- * @brief Lê arquivo texto com sequências de DNA e retorna vetor de strings.
- * @param filename Nome do arquivo de entrada.
- * @return Vetor de strings contendo as sequências de DNA.
- */
-vector<string> read_file(const string& filename) {
-    ifstream file(filename);
-    if (!file.is_open()) {throw runtime_error("Erro ao abrir o arquivo de entrada: " + filename);}
-
-    vector<string> data;
-    string line;
-    while (getline(file, line)) {
-        if (!line.empty()) { data.push_back(line); }
-    }
-    file.close();
-    return data;
-}
+using namespace std;
+using namespace dnasort;
 
-/**
- * @brief Escreve as sequências ordenadas em um arquivo texto.
- * @param filename Nome do arquivo de saída.
- * @param data Vetor de strings com as sequências ordenadas.
- */
-void write_file(const string& filename, const vector<string>& data) {
-    ofstream file(filename);
-    if (!file.is_open()) {throw runtime_error("Erro ao abrir o arquivo de saída: " + filename);}
-
-    for (const auto& seq : data) {
-        file << seq << "\n";
-    }
-    file.close();
-}
+#define DEFAULT_CACHE_MB 1024
 
 /**
  * @brief Função principal. Lê, ordena e grava sequências de DNA.
  * @param argc Número de argumentos.
- * @param argv Vetor de argumentos (entrada, saída).
+ * @param argv Vetor de argumentos (entrada, saída e opções).
  * @return 0 em caso de sucesso, 1 em erro.
  */
 int main(int argc, char** argv) {
-    if (argc != 3) {
-        cerr << "Formato de execução: " << argv[0] << " <arquivo_entrada> <arquivo_saida>\n";
+    SortOptions opts;
+    long index_block = 0;
+    string cache_dir;
+    long cache_max_mb = DEFAULT_CACHE_MB;
+    bool valid = argc >= 3, delimiter = false;
+    for (int i = 3; i < argc && valid; i++) {
+        string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--canonical") {
+            opts.canonical = true;
+        } else if (arg == "--order" && has_value) {
+            valid = parse_collation(argv[++i], opts);
+        } else if (arg == "--key-field" && has_value) {
+            opts.key_field = atoi(argv[++i]);
+            valid = opts.key_field > 0;
+        } else if (arg == "--key-prefix" && has_value) {
+            opts.key_prefix = atoi(argv[++i]);
+            valid = opts.key_prefix > 0 && opts.key_prefix <= MAX_KEY_PREFIX;
+        } else if (arg == "--delimiter" && has_value) {
+            valid = parse_delimiter(argv[++i], opts.delimiter);
+            delimiter = true;
+        } else if (arg == "--index" && has_value) {
+            index_block = atol(argv[++i]);
+            valid = index_block > 0;
+        } else if (arg == "--cache-dir" && has_value) {
+            cache_dir = argv[++i];
+        } else if (arg == "--cache-max-mb" && has_value) {
+            cache_max_mb = atol(argv[++i]);
+            valid = cache_max_mb > 0;
+        } else {
+            valid = false;
+        }
+    }
+    // O índice supõe saída em ordem lexicográfica; os registros são ordenados pelo campo como está
+    bool lexicographic = !opts.canonical && opts.collation == Collation::LEXICOGRAPHIC;
+    if (!valid || (!lexicographic && (index_block > 0 || opts.key_field > 0)) || (opts.key_field > 0 && index_block > 0) ||
+        (delimiter && opts.key_field == 0) ||
+        (opts.key_prefix > 0 && (opts.collation != Collation::LEXICOGRAPHIC || opts.key_field > 0 || index_block > 0))) {
+        cerr << "Formato de execução: " << argv[0] << " <arquivo_entrada> <arquivo_saida> [--canonical] [--order O | --key-field N [--delimiter C] | --key-prefix K | --index B] [--cache-dir DIR [--cache-max-mb N]]\n";
         return 1;
     }
 
@@ -86,6 +97,20 @@ int main(int argc, char** argv) {
         const string input_filename = argv[1];
         const string output_filename = argv[2];
 
+        // Cache: a mesma entrada com as mesmas opções reaproveita a saída anterior
+        unique_ptr<ResultCache> cache;
+        string cache_key;
+        if (!cache_dir.empty()) {
+            auto cache_start = chrono::high_resolution_clock::now();
+            cache.reset(new ResultCache(cache_dir, (uint64_t)cache_max_mb << 20));
+            cache_key = ResultCache::key(input_filename, sort_cache_options(opts, index_block));
+            if (cache->fetch(cache_key, output_filename, index_block > 0)) {
+                chrono::duration<double> elapsed_time = chrono::high_resolution_clock::now() - cache_start;
+                cout << "Resultado obtido do cache em " << elapsed_time.count() << " segundos.\n";
+                return 0;
+            }
+        }
+
         // Lê os dados do arquivo de entrada
         vector<string> dna_sequences = read_file(input_filename);
 
@@ -93,14 +118,15 @@ int main(int argc, char** argv) {
         auto start_time = chrono::high_resolution_clock::now();
 
         // Ordena os dados usando sort
-        sequential_sort(dna_sequences);
+        dnasort::sort(dna_sequences, opts);
 
         // Finaliza medição do tempo
         auto end_time = chrono::high_resolution_clock::now();
         chrono::duration<double> elapsed_time = end_time - start_time;
 
         // Escreve os dados ordenados no arquivo de saída
-        write_file(output_filename, dna_sequences);
+        write_file(output_filename, dna_sequences, index_block);
+        if (cache) cache->store(cache_key, output_filename, index_block > 0);
 
         cout << "Ordenação sequencial concluída em " << elapsed_time.count() << " segundos.\n";
 
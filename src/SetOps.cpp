@@ -0,0 +1,76 @@
+/**
+ * @file SetOps.cpp
+ * @brief Implementação da junção e das operações de conjunto distribuídas.
+ */
+
+#include "SetOps.h"
+
+using namespace std;
+
+namespace dnasort {
+
+/**
+ * @brief Fim do grupo de sequências iguais a data[begin].
+ */
+static size_t group_end(const vector<string>& data, size_t begin) {
+    size_t end = begin + 1;
+    while (end < data.size() && data[end] == data[begin]) end++;
+    return end;
+}
+
+vector<string> set_operation(Comm& comm, vector<string>& a, vector<string>& b, SetOperation op, SortStats* stats) {
+    int rank = comm.rank(), size = comm.size();
+
+    // Ordenação local das duas entradas
+    double local_sort_start = comm.wtime();
+    sequential_sort(a);
+    sequential_sort(b);
+    double local_sort_end = comm.wtime();
+
+    // Pivôs comuns, escolhidos a partir das amostras das duas entradas
+    vector<string> samples = select_samples(a, size - 1);
+    vector<string> samples_b = select_samples(b, size - 1);
+    samples.insert(samples.end(), make_move_iterator(samples_b.begin()), make_move_iterator(samples_b.end()));
+    vector<string> gathered_samples = comm.gather_strings(samples, MASTER);
+
+    vector<string> pivots(size - 1);
+    if (rank == MASTER) pivots = choose_pivots(gathered_samples, size);
+    comm.bcast_strings(pivots, MASTER);
+
+    // Troca por faixas: sequências iguais de A e de B chegam ao mesmo rank
+    vector<string> local_a = exchange_strings(comm, a, pivots);
+    vector<string>().swap(a);
+    vector<string> local_b = exchange_strings(comm, b, pivots);
+    vector<string>().swap(b);
+
+    double final_sort_start = comm.wtime();
+    sequential_sort(local_a);
+    sequential_sort(local_b);
+    double final_sort_end = comm.wtime();
+
+    // Merge-join das partições locais ordenadas
+    vector<string> result;
+    size_t j = 0;
+    for (size_t i = 0; i < local_a.size(); ) {
+        size_t i_end = group_end(local_a, i);
+        while (j < local_b.size() && local_b[j] < local_a[i]) j++;
+        size_t j_end = (j < local_b.size() && local_b[j] == local_a[i]) ? group_end(local_b, j) : j;
+        bool in_b = j_end > j;
+
+        if (op == SetOperation::JOIN) {
+            if (in_b) result.push_back(local_a[i] + "\t" + to_string(i_end - i) + "\t" + to_string(j_end - j));
+        } else if (in_b == (op == SetOperation::INTERSECT)) {
+            result.insert(result.end(), make_move_iterator(local_a.begin() + i), make_move_iterator(local_a.begin() + i_end));
+        }
+        i = i_end;
+        j = j_end;
+    }
+
+    if (stats) {
+        stats->local_sort = local_sort_end - local_sort_start;
+        stats->final_sort = final_sort_end - final_sort_start;
+    }
+    return result;
+}
+
+} // namespace dnasort
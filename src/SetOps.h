@@ -0,0 +1,50 @@
+/**
+ * @file SetOps.h
+ * @brief Junção e operações de conjunto distribuídas entre dois conjuntos de sequências.
+ *
+ * As duas entradas são ordenadas com o Sample Sort usando os mesmos pivôs, de modo que
+ * sequências iguais das duas entradas ficam sempre no mesmo rank; cada rank então percorre as
+ * suas duas partições ordenadas em paralelo (merge-join), sem comparar todos os pares.
+ */
+
+#ifndef SET_OPS_H
+#define SET_OPS_H
+
+#include <string>
+#include <vector>
+
+#include "Comm.h"
+#include "ParallelSort.h"
+
+namespace dnasort {
+
+/**
+ * @brief Operação entre as entradas A e B.
+ */
+enum class SetOperation {
+    JOIN,       ///< Uma linha "seq<tab>contagem_A<tab>contagem_B" por sequência presente em A e em B.
+    INTERSECT,  ///< As sequências de A (com repetições) que ocorrem em B.
+    SUBTRACT    ///< As sequências de A (com repetições) que não ocorrem em B.
+};
+
+/**
+ * @brief Executa a operação entre A e B distribuídos entre os ranks.
+ *
+ * Cada rank ordena suas partições de A e de B e envia size - 1 amostras de cada uma ao MASTER,
+ * que escolhe pivôs comuns às duas entradas; após a troca por faixas, o resultado local sai de
+ * uma única passada pelas duas partições ordenadas. INTERSECT e SUBTRACT dividem A: toda
+ * sequência de A está em exatamente um dos dois resultados.
+ *
+ * @param comm Comunicador dos processos participantes.
+ * @param a Partição local da entrada A (é esvaziada).
+ * @param b Partição local da entrada B (é esvaziada).
+ * @param op Operação.
+ * @param stats Se não nulo, recebe os tempos das ordenações local e final.
+ * @return Partição local do resultado, em ordem; as partições estão em ordem crescente de rank.
+ */
+std::vector<std::string> set_operation(Comm& comm, std::vector<std::string>& a, std::vector<std::string>& b,
+                                       SetOperation op, SortStats* stats = 0);
+
+} // namespace dnasort
+
+#endif // SET_OPS_H
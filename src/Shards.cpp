@@ -0,0 +1,79 @@
+/**
+ * @file Shards.cpp
+ * @brief Implementação da saída particionada por faixas.
+ */
+
+#include "Shards.h"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+#include "DnaSort.h"
+
+using namespace std;
+
+namespace dnasort {
+
+namespace {
+
+/**
+ * @brief Tamanho de uma faixa, reunido no MASTER para o manifesto.
+ */
+struct ShardCount {
+    uint64_t lines;
+    uint64_t bytes;
+};
+
+} // namespace
+
+string shard_filename(const string& manifest, int rank) {
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".shard-%05d", rank);
+    return manifest + suffix;
+}
+
+void write_shards(Comm& comm, const vector<string>& local, const vector<string>& pivots,
+                  const string& manifest, size_t index_block) {
+    int rank = comm.rank(), size = comm.size();
+
+    ShardCount mine = {local.size(), 0};
+    for (const auto& seq : local) mine.bytes += seq.size() + 1;
+
+    string error;
+    try {
+        write_file(shard_filename(manifest, rank), local, index_block);
+    } catch (const exception& e) {
+        error = e.what();
+    }
+    if (allreduce(comm, (uint64_t)!error.empty(), ReduceOp::MAX)) {
+        throw runtime_error(error.empty() ? "Erro ao gravar as faixas de " + manifest : error);
+    }
+
+    vector<ShardCount> counts(size);
+    comm.gather(&mine, sizeof(mine), counts.data(), MASTER);
+
+    uint64_t failed = 0;
+    if (rank == MASTER) {
+        // Os nomes no manifesto são relativos ao diretório do próprio manifesto
+        size_t slash = manifest.find_last_of('/');
+        string base = (slash == string::npos) ? manifest : manifest.substr(slash + 1);
+
+        uint64_t total = 0;
+        for (const auto& c : counts) total += c.lines;
+
+        string tmp = manifest + ".tmp";
+        ofstream file(tmp);
+        file << "SHARDS 1\n" << "shards " << size << "\n" << "lines " << total << "\n";
+        for (int p = 0; p < size; p++) {
+            file << "shard " << shard_filename(base, p) << " " << counts[p].lines << " " << counts[p].bytes << "\n";
+        }
+        for (const auto& pivot : pivots) file << "splitter " << pivot << "\n";
+        file.close();
+        failed = !file || rename(tmp.c_str(), manifest.c_str()) != 0;
+    }
+    comm.bcast(&failed, sizeof(failed), MASTER);
+    if (failed) throw runtime_error("Erro ao abrir o arquivo de saída: " + manifest);
+}
+
+} // namespace dnasort
@@ -0,0 +1,53 @@
+/**
+ * @file Shards.h
+ * @brief Saída particionada por faixas: um arquivo por rank e um manifesto com os pivôs.
+ *
+ * Após a troca e a ordenação final do Sample Sort, cada rank já tem uma faixa contígua da
+ * ordem global. Gravar cada faixa no seu próprio arquivo elimina a coleta no MASTER e a
+ * gravação serial do arquivo único.
+ *
+ * Formato do manifesto (texto):
+ *   SHARDS 1
+ *   shards <P>
+ *   lines <total de sequências>
+ *   shard <arquivo> <sequências> <bytes>   (P linhas, em ordem de faixa; arquivo relativo ao diretório do manifesto)
+ *   splitter <pivô>                        (P - 1 linhas; a faixa p contém as chaves em (pivô p - 1, pivô p])
+ * Os pivôs são gravados como sequências (decode_pivots), e os intervalos seguem a ordem da
+ * execução (--order). Em modo canônico os pivôs são formas canônicas, sem o marcador de
+ * orientação, e as faixas são intervalos de formas canônicas; as sequências cuja forma canônica
+ * é igual a um pivô podem estar na faixa dele ou na seguinte.
+ */
+
+#ifndef SHARDS_H
+#define SHARDS_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Comm.h"
+
+namespace dnasort {
+
+/**
+ * @brief Nome do arquivo da faixa de um rank: "<manifest>.shard-<rank com 5 dígitos>".
+ */
+std::string shard_filename(const std::string& manifest, int rank);
+
+/**
+ * @brief Grava a faixa local de cada rank em seu arquivo e, no MASTER, o manifesto.
+ *
+ * Coletiva; lança runtime_error em todos os ranks se algum rank não conseguir gravar.
+ *
+ * @param comm Comunicador.
+ * @param local Faixa ordenada local (as faixas estão em ordem crescente de rank).
+ * @param pivots Pivôs globais que delimitam as faixas.
+ * @param manifest Nome do manifesto; as faixas são gravadas em shard_filename(manifest, rank).
+ * @param index_block Se > 0, grava também o índice esparso de cada faixa (write_index).
+ */
+void write_shards(Comm& comm, const std::vector<std::string>& local, const std::vector<std::string>& pivots,
+                  const std::string& manifest, std::size_t index_block = 0);
+
+} // namespace dnasort
+
+#endif // SHARDS_H
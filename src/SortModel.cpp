@@ -0,0 +1,151 @@
+/**
+ * @file SortModel.cpp
+ * @brief Programa de previsão do tempo do Sample Sort para vários números de processos.
+ *
+ * Executa as fases locais da ordenação sobre uma amostra da entrada e modela as fases de
+ * comunicação em uma rede LogGP (ver PerfModel.h), imprimindo o tempo previsto de cada fase
+ * para cada número de processos. Serve para planejar a capacidade e comparar os modos de
+ * gravação sem acesso a milhares de processos.
+ *
+ * Execução:
+ *   ./sort_model <arquivo_entrada> [opções]
+ *
+ * Opções:
+ *   --ranks p1,p2,...  - Números de processos (padrão 1,2,4,...,4096).
+ *   --n N              - Número de sequências modelado (padrão: o da entrada).
+ *   --sample S         - Tamanho da amostra (padrão 1000000).
+ *   --latency US       - Parâmetro L da rede, em microssegundos (padrão 2).
+ *   --overhead US      - Parâmetro o da rede, em microssegundos (padrão 1).
+ *   --gap US           - Parâmetro g da rede, em microssegundos (padrão 1).
+ *   --bandwidth MBPS   - Banda por processo (1 / G), em MB/s (padrão 1250).
+ *   --disk MBPS        - Banda de leitura e gravação de arquivos, em MB/s (padrão 1000).
+ *   --canonical        - Modela a ordenação canônica.
+ *   --shards           - Modela a saída por faixas (sem coleta no processo mestre).
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cstdlib>
+
+#include "PerfModel.h"
+
+using namespace std;
+using namespace dnasort;
+
+#define DEFAULT_SAMPLE 1000000
+#define DEFAULT_MAX_RANKS 4096
+#define MIN_SAMPLE_PER_RANK 100 ///< Abaixo disso, o desequilíbrio medido na amostra é impreciso.
+
+/**
+ * @brief Texto alinhado à direita em width caracteres (setw conta bytes, não caracteres UTF-8).
+ */
+static string column(const string& text, size_t width) {
+    size_t chars = 0;
+    for (char c : text) if ((c & 0xC0) != 0x80) chars++;
+    return string(chars < width ? width - chars : 0, ' ') + text;
+}
+
+/**
+ * @brief Função principal. Amostra a entrada e imprime a previsão para cada número de processos.
+ * @param argc Número de argumentos.
+ * @param argv Vetor de argumentos (entrada e opções).
+ * @return 0 em caso de sucesso, 1 em erro.
+ */
+int main(int argc, char** argv) {
+    ModelConfig config;
+    vector<int> ranks;
+    uint64_t n = 0;
+    long sample_size = DEFAULT_SAMPLE;
+    bool valid = argc >= 2;
+    for (int i = 2; valid && i < argc; i++) {
+        string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--ranks" && has_value) {
+            string list = argv[++i];
+            for (size_t start = 0; start <= list.size(); ) {
+                size_t end = list.find(',', start);
+                if (end == string::npos) end = list.size();
+                int p = atoi(list.substr(start, end - start).c_str());
+                if (p <= 0) valid = false;
+                ranks.push_back(p);
+                start = end + 1;
+            }
+        } else if (arg == "--n" && has_value) {
+            n = strtoull(argv[++i], 0, 10);
+            if (n == 0) valid = false;
+        } else if (arg == "--sample" && has_value) {
+            sample_size = atol(argv[++i]);
+            if (sample_size <= 0) valid = false;
+        } else if (arg == "--latency" && has_value) {
+            config.net.L = atof(argv[++i]) * 1e-6;
+        } else if (arg == "--overhead" && has_value) {
+            config.net.o = atof(argv[++i]) * 1e-6;
+        } else if (arg == "--gap" && has_value) {
+            config.net.g = atof(argv[++i]) * 1e-6;
+        } else if (arg == "--bandwidth" && has_value) {
+            double mbps = atof(argv[++i]);
+            if (mbps <= 0) valid = false;
+            else config.net.G = 1 / (mbps * 1e6);
+        } else if (arg == "--disk" && has_value) {
+            double mbps = atof(argv[++i]);
+            if (mbps <= 0) valid = false;
+            else config.disk_bytes_per_second = mbps * 1e6;
+        } else if (arg == "--canonical") {
+            config.canonical = true;
+        } else if (arg == "--shards") {
+            config.shards = true;
+        } else {
+            valid = false;
+        }
+    }
+    if (!valid || config.net.L < 0 || config.net.o < 0 || config.net.g < 0) {
+        cerr << "Formato de execução: " << argv[0] << " <arquivo_entrada> [--ranks p1,p2,...] [--n N] [--sample S] [--latency US] [--overhead US] [--gap US] [--bandwidth MBPS] [--disk MBPS] [--canonical] [--shards]\n";
+        return 1;
+    }
+    if (ranks.empty()) for (int p = 1; p <= DEFAULT_MAX_RANKS; p *= 2) ranks.push_back(p);
+
+    try {
+        uint64_t lines = 0;
+        vector<string> sample = sample_lines(argv[1], sample_size, &lines);
+        if (n == 0) n = lines;
+        if (sample.empty()) {
+            cerr << "Erro: entrada vazia: " << argv[1] << "\n";
+            return 1;
+        }
+
+        SortModel model(sample, n, config);
+        cout << "Modelo: " << n << " sequências (" << fixed << setprecision(1) << model.bytes_per_sequence()
+             << " bytes cada), amostra de " << sample.size() << "; L=" << config.net.L * 1e6 << " us, o="
+             << config.net.o * 1e6 << " us, g=" << config.net.g * 1e6 << " us, banda=" << 1e-6 / config.net.G
+             << " MB/s, disco=" << config.disk_bytes_per_second / 1e6 << " MB/s"
+             << (config.canonical ? ", canônica" : "") << (config.shards ? ", faixas" : "") << "\n\n";
+
+        const char* headers[] = {"leitura", "distrib.", "ord.loc.", "amostras", "pivôs", "troca", "ord.fin.",
+                                 "coleta", "gravação", "total"};
+        cout << column("P", 6);
+        for (const char* header : headers) cout << column(header, 10);
+        cout << column("acel.", 9) << column("deseq.", 9) << "\n";
+        cout << setprecision(3);
+        double base = 0;
+        bool imprecise = false;
+        for (int p : ranks) {
+            ModelPrediction pred = model.predict(p);
+            if (base == 0) base = pred.total();
+            bool rough = sample.size() < (size_t)p * MIN_SAMPLE_PER_RANK;
+            imprecise = imprecise || rough;
+            cout << setw(6) << p << setw(10) << pred.read << setw(10) << pred.distribute << setw(10) << pred.local_sort
+                 << setw(10) << pred.samples << setw(10) << pred.pivots << setw(10) << pred.exchange
+                 << setw(10) << pred.final_sort << setw(10) << pred.gather << setw(10) << pred.write
+                 << setw(10) << pred.total() << setw(9) << setprecision(2) << base / pred.total()
+                 << setw(8) << pred.imbalance << (rough ? "*" : " ") << setprecision(3) << "\n";
+        }
+        cout << "\nTempos em segundos, no processo mais lento; acel. = tempo com " << ranks[0] << " processo(s) / tempo com P.\n";
+        if (imprecise) cout << "* amostra com menos de " << MIN_SAMPLE_PER_RANK << " sequências por processo: desequilíbrio impreciso (aumente --sample).\n";
+    } catch (const exception& e) {
+        cerr << "Erro: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,310 @@
+/**
+ * @file SortStore.cpp
+ * @brief Implementação do conjunto ordenado incremental com compactação por camadas.
+ */
+
+#include "SortStore.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+#include "DnaSort.h"
+#include "Merge.h"
+
+using namespace std;
+
+namespace dnasort {
+
+static const string RUN_PREFIX = "run-";
+
+SortStore::SortStore(const string& dir, const StoreOptions& opts) : dir_(dir), opts_(opts) {
+    if (!opts_.read_only && mkdir(dir_.c_str(), 0755) != 0 && errno != EEXIST) {
+        throw runtime_error("Erro ao criar o diretório do conjunto: " + dir_);
+    }
+
+    // Escritores excluem todos os demais processos; leitores excluem apenas os escritores
+    string lock_name = dir_ + "/LOCK";
+    lock_fd_ = open(lock_name.c_str(), O_RDONLY | O_CREAT, 0644);
+    if (lock_fd_ < 0) throw runtime_error("Erro ao abrir o arquivo de lock: " + lock_name);
+    int result;
+    while ((result = flock(lock_fd_, opts_.read_only ? LOCK_SH : LOCK_EX)) != 0 && errno == EINTR) {}
+    if (result != 0) {
+        close(lock_fd_);
+        throw runtime_error("Erro ao obter o lock do conjunto: " + lock_name);
+    }
+    try {
+        read_manifest();
+    } catch (...) {
+        close(lock_fd_);
+        throw;
+    }
+    if (opts_.read_only) return;
+
+    // Remove runs que não chegaram ao MANIFEST; com o lock exclusivo, nenhum outro processo
+    // está gravando uma run ou trocando o MANIFEST
+    set<string> active;
+    for (const auto& r : runs_) active.insert(r.name);
+    if (DIR* d = opendir(dir_.c_str())) {
+        while (dirent* entry = readdir(d)) {
+            string name = entry->d_name;
+            if (name.compare(0, RUN_PREFIX.size(), RUN_PREFIX) == 0 && !active.count(name)) {
+                unlink((dir_ + "/" + name).c_str());
+            }
+        }
+        closedir(d);
+    }
+}
+
+SortStore::~SortStore() {
+    wait();
+    close(lock_fd_);  // libera o flock
+}
+
+void SortStore::check_writable() const {
+    if (opts_.read_only) throw runtime_error("Conjunto aberto apenas para leitura: " + dir_);
+}
+
+void SortStore::read_manifest() {
+    ifstream file(dir_ + "/MANIFEST");
+    if (!file.is_open()) return;  // conjunto novo
+
+    string line;
+    if (!getline(file, line) || line != "SORTSTORE 1") {
+        throw runtime_error("MANIFEST inválido em " + dir_);
+    }
+    while (getline(file, line)) {
+        istringstream fields(line);
+        string kind;
+        fields >> kind;
+        if (kind == "next") {
+            fields >> next_id_;
+        } else if (kind == "run") {
+            RunInfo r = {"", 0, 0, false};
+            fields >> r.name >> r.bytes >> r.lines;
+            runs_.push_back(r);
+        }
+        if (!fields) throw runtime_error("MANIFEST inválido em " + dir_);
+    }
+}
+
+void SortStore::write_manifest() {
+    string tmp = dir_ + "/MANIFEST.tmp";
+    {
+        ofstream file(tmp);
+        file << "SORTSTORE 1\n" << "next " << next_id_ << "\n";
+        for (const auto& r : runs_) file << "run " << r.name << " " << r.bytes << " " << r.lines << "\n";
+        if (!file) throw runtime_error("Erro ao gravar o MANIFEST em " + dir_);
+    }
+    if (rename(tmp.c_str(), (dir_ + "/MANIFEST").c_str()) != 0) {
+        throw runtime_error("Erro ao gravar o MANIFEST em " + dir_);
+    }
+}
+
+string SortStore::new_run_name() {
+    char name[32];
+    snprintf(name, sizeof(name), "%s%08llu.txt", RUN_PREFIX.c_str(), (unsigned long long)next_id_++);
+    return name;
+}
+
+int SortStore::tier(uint64_t bytes) const {
+    if (bytes <= opts_.base_bytes) return 0;
+    return 1 + (int)floor(log((double)bytes / opts_.base_bytes) / log(opts_.tier_ratio));
+}
+
+vector<RunInfo> SortStore::pick_compaction(bool all) {
+    // Runs livres agrupadas por camada
+    map<int, vector<size_t>> tiers;
+    for (size_t i = 0; i < runs_.size(); i++) {
+        if (!runs_[i].busy) tiers[all ? 0 : tier(runs_[i].bytes)].push_back(i);
+    }
+
+    vector<RunInfo> picked;
+    for (const auto& t : tiers) {
+        size_t needed = all ? 2 : (size_t)opts_.min_merge;
+        if (t.second.size() >= needed) {
+            for (size_t i : t.second) {
+                runs_[i].busy = true;
+                picked.push_back(runs_[i]);
+            }
+            break;
+        }
+    }
+    return picked;
+}
+
+void SortStore::run_compaction(const vector<RunInfo>& inputs) {
+    // As runs são imutáveis: a intercalação não precisa do mutex
+    vector<unique_ptr<MappedFile>> files;
+    vector<LineRange> ranges;
+    for (const auto& r : inputs) {
+        files.emplace_back(new MappedFile(dir_ + "/" + r.name));
+        ranges.push_back(LineRange{files.back()->data(), files.back()->size(), 0, files.back()->size()});
+    }
+
+    string name;
+    {
+        lock_guard<mutex> lock(mutex_);
+        name = new_run_name();
+    }
+    string path = dir_ + "/" + name;
+    RunInfo merged = {name, 0, 0, false};
+    {
+        ofstream out(path + ".tmp", ios::binary);
+        if (!out.is_open()) {throw runtime_error("Erro ao abrir o arquivo de saída: " + path);}
+        merge_line_ranges(ranges, [&](const LineRef& line) {
+            out.write(line.data, line.len);
+            out.put('\n');
+            merged.bytes += line.len + 1;
+            merged.lines++;
+        });
+        if (!out) throw runtime_error("Erro ao gravar " + path);
+    }
+    if (rename((path + ".tmp").c_str(), path.c_str()) != 0) throw runtime_error("Erro ao gravar " + path);
+
+    // Troca atômica das runs de entrada pela run intercalada
+    {
+        lock_guard<mutex> lock(mutex_);
+        set<string> replaced;
+        for (const auto& r : inputs) replaced.insert(r.name);
+        vector<RunInfo> remaining;
+        for (const auto& r : runs_) if (!replaced.count(r.name)) remaining.push_back(r);
+        remaining.push_back(merged);
+        runs_.swap(remaining);
+        write_manifest();
+    }
+    // Leituras em andamento mantêm os arquivos mapeados mesmo após a remoção
+    for (const auto& r : inputs) unlink((dir_ + "/" + r.name).c_str());
+}
+
+/**
+ * @brief Libera as runs marcadas como em compactação.
+ */
+static void release_runs(vector<RunInfo>& runs, const vector<RunInfo>& inputs) {
+    set<string> names;
+    for (const auto& r : inputs) names.insert(r.name);
+    for (auto& r : runs) if (names.count(r.name)) r.busy = false;
+}
+
+void SortStore::compaction_loop() {
+    while (true) {
+        vector<RunInfo> inputs;
+        {
+            lock_guard<mutex> lock(mutex_);
+            inputs = pick_compaction(false);
+            if (inputs.empty()) { compacting_ = false; return; }
+        }
+        try {
+            run_compaction(inputs);
+        } catch (const exception& e) {
+            cerr << "Erro na compactação: " << e.what() << endl;
+            lock_guard<mutex> lock(mutex_);
+            release_runs(runs_, inputs);
+            compacting_ = false;
+            return;
+        }
+    }
+}
+
+void SortStore::append(vector<string>& batch) {
+    check_writable();
+    if (batch.empty()) return;
+    dnasort::sort(batch);
+
+    string name;
+    {
+        lock_guard<mutex> lock(mutex_);
+        name = new_run_name();
+    }
+    string path = dir_ + "/" + name;
+    RunInfo run = {name, 0, batch.size(), false};
+    for (const auto& seq : batch) run.bytes += seq.size() + 1;
+    write_file(path + ".tmp", batch);
+    if (rename((path + ".tmp").c_str(), path.c_str()) != 0) throw runtime_error("Erro ao gravar " + path);
+    vector<string>().swap(batch);
+
+    lock_guard<mutex> lock(mutex_);
+    runs_.push_back(run);
+    write_manifest();
+    if (opts_.background && !compacting_) {
+        if (compactor_.joinable()) compactor_.join();
+        compacting_ = true;
+        compactor_ = thread(&SortStore::compaction_loop, this);
+    }
+}
+
+bool SortStore::compact(bool all) {
+    check_writable();
+    vector<RunInfo> inputs;
+    {
+        lock_guard<mutex> lock(mutex_);
+        inputs = pick_compaction(all);
+    }
+    if (inputs.empty()) return false;
+    try {
+        run_compaction(inputs);
+    } catch (...) {
+        lock_guard<mutex> lock(mutex_);
+        release_runs(runs_, inputs);
+        throw;
+    }
+    return true;
+}
+
+void SortStore::wait() {
+    unique_lock<mutex> lock(mutex_);
+    while (compactor_.joinable()) {
+        thread t;
+        t.swap(compactor_);
+        lock.unlock();
+        t.join();
+        lock.lock();
+    }
+}
+
+vector<RunInfo> SortStore::runs() const {
+    lock_guard<mutex> lock(mutex_);
+    return runs_;
+}
+
+void SortStore::scan(const function<void(const LineRef&)>& visit) const {
+    // Mapeia as runs com o mutex para que nenhuma seja removida antes de ser aberta
+    vector<unique_ptr<MappedFile>> files;
+    vector<LineRange> ranges;
+    {
+        lock_guard<mutex> lock(mutex_);
+        for (const auto& r : runs_) {
+            files.emplace_back(new MappedFile(dir_ + "/" + r.name));
+            ranges.push_back(LineRange{files.back()->data(), files.back()->size(), 0, files.back()->size()});
+        }
+    }
+    merge_line_ranges(ranges, visit);
+}
+
+uint64_t SortStore::export_file(const string& filename) const {
+    ofstream out(filename, ios::binary);
+    if (!out.is_open()) {throw runtime_error("Erro ao abrir o arquivo de saída: " + filename);}
+    uint64_t lines = 0;
+    scan([&](const LineRef& line) {
+        out.write(line.data, line.len);
+        out.put('\n');
+        lines++;
+    });
+    if (!out) throw runtime_error("Erro ao gravar " + filename);
+    return lines;
+}
+
+} // namespace dnasort
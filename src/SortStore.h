@@ -0,0 +1,132 @@
+/**
+ * @file SortStore.h
+ * @brief Conjunto ordenado incremental de sequências (estilo LSM) com compactação em segundo plano.
+ *
+ * Cada lote acrescentado é ordenado em memória e gravado como uma run imutável (arquivo texto
+ * ordenado, uma sequência por linha) no diretório do conjunto. O arquivo MANIFEST lista as runs
+ * ativas e é sempre substituído de forma atômica (gravação em MANIFEST.tmp seguida de rename).
+ * Runs de tamanho semelhante (mesma camada) são intercaladas em uma run maior por compactação
+ * por camadas (size-tiered), de modo que acrescentar dados custa O(dados novos) e cada sequência
+ * é reescrita O(log n) vezes. A leitura é uma visão intercalada de todas as runs.
+ *
+ * Exemplo de uso:
+ *   dnasort::SortStore store("dados.store");
+ *   store.append(lote);                              // ordena e grava uma nova run
+ *   store.scan([](const dnasort::LineRef& seq) {});  // sequências em ordem crescente
+ *
+ * Os processos que alteram o conjunto obtêm um flock exclusivo em <diretório>/LOCK, e os de
+ * apenas leitura (StoreOptions::read_only) um flock compartilhado, mantidos enquanto o objeto
+ * existir: um escritor espera os leitores e os demais escritores, e vice-versa.
+ */
+
+#ifndef SORT_STORE_H
+#define SORT_STORE_H
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MappedFile.h"
+
+namespace dnasort {
+
+/**
+ * @brief Parâmetros da compactação por camadas.
+ */
+struct StoreOptions {
+    int min_merge = 4;                ///< Runs da mesma camada que disparam uma compactação.
+    double tier_ratio = 4;            ///< Razão de tamanho entre camadas consecutivas.
+    uint64_t base_bytes = 1 << 20;    ///< Runs até este tamanho ficam na camada 0.
+    bool background = true;           ///< Compacta automaticamente em uma thread após cada append.
+    bool read_only = false;           ///< Apenas leitura: não cria o diretório, não remove arquivos e não aceita append/compact.
+};
+
+/**
+ * @brief Run imutável listada no MANIFEST.
+ */
+struct RunInfo {
+    std::string name;    ///< Nome do arquivo no diretório do conjunto.
+    uint64_t bytes;      ///< Tamanho do arquivo.
+    uint64_t lines;      ///< Número de sequências.
+    bool busy;           ///< Em compactação (apenas em memória).
+};
+
+/**
+ * @brief Conjunto ordenado incremental armazenado em um diretório.
+ */
+class SortStore {
+public:
+    /**
+     * @brief Abre o conjunto do diretório dir, criando-o se não existir (exceto com opts.read_only).
+     *
+     * Espera o flock de <diretório>/LOCK. No modo de escrita, com o lock exclusivo, arquivos de
+     * runs que não estão no MANIFEST (restos de uma execução interrompida) são removidos.
+     */
+    explicit SortStore(const std::string& dir, const StoreOptions& opts = StoreOptions());
+
+    /** @brief Espera a compactação em andamento e libera o LOCK. */
+    ~SortStore();
+
+    /**
+     * @brief Ordena um lote e o acrescenta como uma nova run.
+     * @param batch Sequências do lote (é esvaziado).
+     */
+    void append(std::vector<std::string>& batch);
+
+    /**
+     * @brief Executa uma compactação por camadas, se alguma camada tem runs suficientes.
+     * @param all Se true, intercala todas as runs em uma só.
+     * @return true se alguma compactação foi executada.
+     */
+    bool compact(bool all = false);
+
+    /** @brief Espera o término da compactação em segundo plano. */
+    void wait();
+
+    /** @brief Runs ativas. */
+    std::vector<RunInfo> runs() const;
+
+    /** @brief Camada de uma run com o tamanho dado. */
+    int tier(uint64_t bytes) const;
+
+    /**
+     * @brief Visão intercalada: chama visit com cada sequência do conjunto em ordem crescente.
+     *
+     * As runs são mapeadas no início da leitura, que não é afetada por compactações simultâneas.
+     */
+    void scan(const std::function<void(const LineRef&)>& visit) const;
+
+    /**
+     * @brief Grava a visão intercalada em um arquivo texto.
+     * @return Número de sequências gravadas.
+     */
+    uint64_t export_file(const std::string& filename) const;
+
+private:
+    SortStore(const SortStore&);
+    SortStore& operator=(const SortStore&);
+
+    void read_manifest();
+    void write_manifest();                         // com mutex_ obtido
+    std::string new_run_name();                    // com mutex_ obtido
+    std::vector<RunInfo> pick_compaction(bool all); // com mutex_ obtido; marca as runs como busy
+    void run_compaction(const std::vector<RunInfo>& inputs);
+    void compaction_loop();
+    void check_writable() const;
+
+    std::string dir_;
+    StoreOptions opts_;
+    mutable std::mutex mutex_;
+    std::vector<RunInfo> runs_;
+    uint64_t next_id_ = 1;
+    std::thread compactor_;
+    bool compacting_ = false;
+    int lock_fd_ = -1;
+};
+
+} // namespace dnasort
+
+#endif // SORT_STORE_H
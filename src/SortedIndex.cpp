@@ -0,0 +1,105 @@
+/**
+ * @file SortedIndex.cpp
+ * @brief Implementação das consultas sobre arquivo ordenado com índice esparso.
+ */
+
+#include "SortedIndex.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+namespace dnasort {
+
+#define INDEX_HEADER_BYTES (4 + 4 * sizeof(uint64_t))
+
+SortedIndex::SortedIndex(const string& filename) : data_(filename), index_(filename + ".idx") {
+    const char* p = index_.data();
+    if (index_.size() < INDEX_HEADER_BYTES || memcmp(p, "SIDX", 4) != 0) {
+        throw runtime_error("Índice inválido: " + filename + ".idx");
+    }
+    uint64_t header[4];
+    memcpy(header, p + 4, sizeof(header));
+    entry_count_ = header[1];
+    total_lines_ = header[2];
+    if (header[3] != data_.size() || index_.size() < INDEX_HEADER_BYTES + entry_count_ * sizeof(IndexEntry)) {
+        throw runtime_error("Índice não corresponde ao arquivo: " + filename);
+    }
+    entries_ = p + INDEX_HEADER_BYTES;
+    keys_ = p + INDEX_HEADER_BYTES + entry_count_ * sizeof(IndexEntry);
+}
+
+/**
+ * @brief true se line começa com prefix.
+ */
+static inline bool starts_with(const LineRef& line, const string& prefix) {
+    return line.len >= prefix.size() && memcmp(line.data, prefix.data(), prefix.size()) == 0;
+}
+
+template <typename Pred>
+SortedIndex::Position SortedIndex::partition_point(Pred goes_left) const {
+    // Primeiro bloco cuja primeira linha não vai para a esquerda
+    uint64_t lo = 0, hi = entry_count_;
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (goes_left(key(mid))) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == 0) return Position{0, 0};
+
+    // A resposta está no bloco anterior ou no início do bloco lo
+    IndexEntry block = entry(lo - 1);
+    uint64_t line = block.line, pos = block.offset;
+    uint64_t end = (lo < entry_count_) ? entry(lo).offset : data_.size();
+    while (pos < end && goes_left(line_at(data_.data(), data_.size(), pos))) {
+        pos = next_line(data_.data(), data_.size(), pos);
+        line++;
+    }
+    return Position{line, pos};
+}
+
+SortedIndex::Position SortedIndex::lower_bound(const string& key) const {
+    LineRef k = {key.data(), key.size()};
+    return partition_point([&](const LineRef& line) { return line < k; });
+}
+
+SortedIndex::Position SortedIndex::upper_bound(const string& key) const {
+    LineRef k = {key.data(), key.size()};
+    return partition_point([&](const LineRef& line) { return !(k < line); });
+}
+
+SortedIndex::Position SortedIndex::prefix_end(const string& prefix) const {
+    LineRef p = {prefix.data(), prefix.size()};
+    return partition_point([&](const LineRef& line) { return line < p || starts_with(line, prefix); });
+}
+
+uint64_t SortedIndex::count(const string& key) const {
+    return upper_bound(key).line - lower_bound(key).line;
+}
+
+uint64_t SortedIndex::count_prefix(const string& prefix) const {
+    return prefix_end(prefix).line - lower_bound(prefix).line;
+}
+
+void build_index(const string& filename, size_t block) {
+    // Uma passada sobre o arquivo mapeado: todas as linhas contam, inclusive as vazias
+    MappedFile data(filename);
+    vector<IndexEntry> entries;
+    string keys;
+    uint64_t lines = 0;
+    LineRef previous = {0, 0};
+    for (uint64_t pos = 0; pos < data.size(); pos = next_line(data.data(), data.size(), pos), lines++) {
+        LineRef line = line_at(data.data(), data.size(), pos);
+        if (lines > 0 && line < previous) throw runtime_error("Arquivo não está ordenado: " + filename);
+        if (lines % block == 0) {
+            entries.push_back(IndexEntry{pos, lines, keys.size(), line.len});
+            keys.append(line.data, line.len);
+        }
+        previous = line;
+    }
+    write_index_entries(filename, block, entries, keys, lines, data.size());
+}
+
+} // namespace dnasort
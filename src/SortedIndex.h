@@ -0,0 +1,110 @@
+/**
+ * @file SortedIndex.h
+ * @brief Consultas por busca binária em um arquivo ordenado com índice esparso (write_index).
+ */
+
+#ifndef SORTED_INDEX_H
+#define SORTED_INDEX_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "DnaSort.h"
+#include "MappedFile.h"
+
+namespace dnasort {
+
+/**
+ * @brief Arquivo ordenado e seu índice esparso, ambos mapeados em memória.
+ *
+ * Cada consulta faz uma busca binária nas chaves do índice (a primeira linha de cada bloco) e
+ * percorre no máximo um bloco do arquivo de dados, de modo que o custo é O(log(n / B) + B)
+ * comparações para blocos de B linhas.
+ */
+class SortedIndex {
+public:
+    /**
+     * @brief Posição de uma linha no arquivo de dados.
+     */
+    struct Position {
+        uint64_t line;    ///< Número da linha (base 0).
+        uint64_t offset;  ///< Deslocamento em bytes.
+    };
+
+    /**
+     * @param filename Arquivo de dados ordenado; o índice é "<filename>.idx". Lança runtime_error
+     *                 se o índice não existe ou não corresponde ao arquivo de dados.
+     */
+    explicit SortedIndex(const std::string& filename);
+
+    /** @brief Número de linhas do arquivo de dados. */
+    uint64_t lines() const { return total_lines_; }
+
+    /** @brief Primeira linha não menor que key. */
+    Position lower_bound(const std::string& key) const;
+
+    /** @brief Primeira linha maior que key. */
+    Position upper_bound(const std::string& key) const;
+
+    /** @brief Primeira linha maior que key e que não começa com prefix. */
+    Position prefix_end(const std::string& prefix) const;
+
+    /** @brief Número de ocorrências exatas de key. */
+    uint64_t count(const std::string& key) const;
+
+    /** @brief Número de linhas que começam com prefix. */
+    uint64_t count_prefix(const std::string& prefix) const;
+
+    /**
+     * @brief Chama visit com cada linha de [first, last).
+     */
+    template <typename Visit>
+    void visit(Position first, Position last, Visit visit) const {
+        for (uint64_t pos = first.offset; pos < last.offset; pos = next_line(data_.data(), data_.size(), pos)) {
+            visit(line_at(data_.data(), data_.size(), pos));
+        }
+    }
+
+private:
+    /** @brief Primeira linha para a qual goes_left é falso (goes_left deve ser monótono). */
+    template <typename Pred>
+    Position partition_point(Pred goes_left) const;
+
+    /**
+     * @brief Cópia da entrada i; as entradas começam após o cabeçalho de 36 bytes e não estão
+     *        alinhadas a 8 bytes no arquivo mapeado.
+     */
+    IndexEntry entry(uint64_t i) const {
+        IndexEntry e;
+        std::memcpy(&e, entries_ + i * sizeof(IndexEntry), sizeof(IndexEntry));
+        return e;
+    }
+
+    LineRef key(uint64_t i) const {
+        IndexEntry e = entry(i);
+        return LineRef{keys_ + e.key_pos, (std::size_t)e.key_len};
+    }
+
+    MappedFile data_;
+    MappedFile index_;
+    const char* entries_;
+    const char* keys_;
+    uint64_t entry_count_;
+    uint64_t total_lines_;
+};
+
+/**
+ * @brief Grava o índice esparso (write_index) de um arquivo ordenado já existente.
+ *
+ * O arquivo é percorrido uma vez, mapeado em memória, sem ser carregado; as linhas vazias
+ * também são contadas. Lança runtime_error se o arquivo não estiver ordenado.
+ *
+ * @param filename Arquivo de dados, uma sequência por linha em ordem lexicográfica.
+ * @param block Linhas por bloco.
+ */
+void build_index(const std::string& filename, std::size_t block);
+
+} // namespace dnasort
+
+#endif // SORTED_INDEX_H
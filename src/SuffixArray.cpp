@@ -0,0 +1,179 @@
+/**
+ * @file SuffixArray.cpp
+ * @brief Implementação da construção distribuída do vetor de sufixos.
+ */
+
+#include "SuffixArray.h"
+
+#include <fstream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace dnasort {
+
+namespace {
+
+/**
+ * @brief Tupla ordenada na construção do vetor de sufixos.
+ */
+struct SuffixTuple {
+    uint64_t name;  ///< Nome do prefixo de tamanho h do sufixo.
+    uint64_t next;  ///< Nome do prefixo de tamanho h que começa h posições adiante (0 além do fim).
+    uint64_t pos;   ///< Posição do sufixo no texto.
+
+    bool operator<(const SuffixTuple& other) const {
+        if (name != other.name) return name < other.name;
+        if (next != other.next) return next < other.next;
+        return pos < other.pos;
+    }
+
+    bool same_key(uint64_t other_name, uint64_t other_next) const {
+        return name == other_name && next == other_next;
+    }
+};
+
+/**
+ * @brief Novo nome de uma posição do texto, devolvido ao processo dono da posição.
+ */
+struct SuffixName {
+    uint64_t pos;
+    uint64_t name;
+};
+
+/**
+ * @brief Última chave (name, next) da partição ordenada de um processo.
+ */
+struct SuffixBoundary {
+    uint64_t has_data;
+    uint64_t name;
+    uint64_t next;
+};
+
+/**
+ * @brief Processo dono de uma posição do texto distribuído em blocos contíguos.
+ * @param offsets Posição inicial do bloco de cada processo.
+ * @param pos Posição global.
+ * @return Rank do processo dono.
+ */
+inline int owner_of(const vector<uint64_t>& offsets, uint64_t pos) {
+    return upper_bound(offsets.begin(), offsets.end(), pos) - offsets.begin() - 1;
+}
+
+} // namespace
+
+/**
+ * A cada iteração h, cada posição i forma a tupla (nome[i], nome[i + h], i),
+ * obtendo nome[i + h] com um único alltoallv, e as tuplas são ordenadas globalmente com as
+ * mesmas fases do Sample Sort (ordenação local, amostras, pivôs, troca e ordenação final).
+ * O novo nome de cada sufixo é 1 + a posição global da primeira tupla com a mesma chave,
+ * calculada com exscan, e é devolvido ao dono da posição. O processo termina quando todos
+ * os nomes são distintos, após O(log LCP máximo) iterações.
+ */
+vector<uint64_t> build_suffix_array(Comm& comm, const vector<string>& local, int* iterations) {
+    int rank = comm.rank(), size = comm.size();
+
+    // Texto local e nomes iniciais (um por caractere)
+    vector<uint64_t> names;
+    for (const auto& seq : local) {
+        for (char c : seq) names.push_back((unsigned char)c + 1);
+        names.push_back((unsigned char)'$' + 1);
+    }
+
+    uint64_t len = names.size();
+    uint64_t offset = exscan(comm, len, ReduceOp::SUM);
+    vector<uint64_t> offsets(size);
+    comm.allgather(&offset, sizeof(offset), offsets.data());
+
+    vector<uint64_t> suffix_array;
+    int iteration_count = 0;
+    for (uint64_t h = 1; ; h *= 2) {
+        iteration_count++;
+
+        // nome[i + h]: cada posição j envia seu nome ao dono da posição j - h
+        vector<size_t> shift_counts(size, 0);
+        vector<uint64_t> shift_send;
+        for (uint64_t i = 0; i < len; i++) {
+            uint64_t pos = offset + i;
+            if (pos >= h) {
+                shift_counts[owner_of(offsets, pos - h)]++;
+                shift_send.push_back(names[i]);
+            }
+        }
+        vector<uint64_t> shifted = alltoallv_pod(comm, shift_send, shift_counts);
+
+        vector<SuffixTuple> tuples(len);
+        for (uint64_t i = 0; i < len; i++) {
+            tuples[i] = SuffixTuple{names[i], i < shifted.size() ? shifted[i] : 0, offset + i};
+        }
+
+        // Ordenação global das tuplas com as fases do Sample Sort
+        std::sort(tuples.begin(), tuples.end());
+        vector<SuffixTuple> pivots = sample_pivots(comm, tuples);
+        vector<SuffixTuple> sorted = exchange_sorted(comm, tuples, pivots);
+        vector<SuffixTuple>().swap(tuples);
+        std::sort(sorted.begin(), sorted.end());
+
+        // Renomeação: nome = 1 + posição global do início do grupo de chaves iguais
+        uint64_t count = sorted.size();
+        uint64_t first = exscan(comm, count, ReduceOp::SUM);
+
+        SuffixBoundary mine = {0, 0, 0};
+        if (count > 0) mine = SuffixBoundary{1, sorted.back().name, sorted.back().next};
+        vector<SuffixBoundary> boundaries(size);
+        comm.allgather(&mine, sizeof(mine), boundaries.data());
+
+        SuffixBoundary prev = {0, 0, 0};
+        for (int p = rank - 1; p >= 0 && !prev.has_data; p--) prev = boundaries[p];
+
+        vector<uint64_t> new_names(count);
+        uint64_t running = 0, duplicates = 0;
+        for (uint64_t k = 0; k < count; k++) {
+            bool is_head = (k == 0)
+                ? !(prev.has_data && sorted[k].same_key(prev.name, prev.next))
+                : !sorted[k].same_key(sorted[k - 1].name, sorted[k - 1].next);
+            if (is_head) running = first + k + 1;
+            else duplicates = 1;
+            new_names[k] = running;
+        }
+        uint64_t carry = exscan(comm, running, ReduceOp::MAX);
+        uint64_t any_duplicates = allreduce(comm, duplicates, ReduceOp::MAX);
+
+        if (!any_duplicates) {
+            suffix_array.resize(count);
+            for (uint64_t k = 0; k < count; k++) suffix_array[k] = sorted[k].pos;
+            break;
+        }
+
+        // Devolução dos novos nomes aos donos das posições
+        vector<size_t> name_counts(size, 0);
+        vector<int> owners(count);
+        for (uint64_t k = 0; k < count; k++) {
+            owners[k] = owner_of(offsets, sorted[k].pos);
+            name_counts[owners[k]]++;
+        }
+        vector<size_t> next_slot(size, 0);
+        for (int p = 1; p < size; p++) next_slot[p] = next_slot[p - 1] + name_counts[p - 1];
+        vector<SuffixName> name_send(count);
+        for (uint64_t k = 0; k < count; k++) {
+            name_send[next_slot[owners[k]]++] = SuffixName{sorted[k].pos, max(carry, new_names[k])};
+        }
+        vector<SuffixName> received = alltoallv_pod(comm, name_send, name_counts);
+        for (const auto& r : received) names[r.pos - offset] = r.name;
+    }
+    if (iterations) *iterations = iteration_count;
+    return suffix_array;
+}
+
+void write_suffix_array_file(const string& filename, const vector<uint64_t>& suffix_array) {
+    ofstream file(filename, ios::binary);
+    if (!file.is_open()) {throw runtime_error("Erro ao abrir o arquivo de saída: " + filename);}
+
+    uint64_t n = suffix_array.size();
+    file.write("SUFA", 4);
+    file.write((const char*)&n, sizeof(n));
+    file.write((const char*)suffix_array.data(), n * sizeof(uint64_t));
+    file.close();
+}
+
+} // namespace dnasort
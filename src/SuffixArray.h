@@ -0,0 +1,44 @@
+/**
+ * @file SuffixArray.h
+ * @brief Construção distribuída do vetor de sufixos sobre as fases do Sample Sort.
+ */
+
+#ifndef SUFFIX_ARRAY_H
+#define SUFFIX_ARRAY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ParallelSort.h"
+
+namespace dnasort {
+
+/**
+ * @brief Construção distribuída do vetor de sufixos por duplicação de prefixos.
+ *
+ * O texto é a concatenação das sequências locais, cada uma seguida de '$', distribuído em
+ * blocos contíguos em ordem de rank.
+ *
+ * @param comm Comunicador dos processos participantes.
+ * @param local Partição local de sequências, em ordem de entrada.
+ * @param iterations Se não nulo, recebe o número de iterações executadas.
+ * @return Trecho local do vetor de sufixos (posições globais, em ordem de sufixo); os trechos
+ *         estão em ordem crescente de rank.
+ */
+std::vector<uint64_t> build_suffix_array(Comm& comm, const std::vector<std::string>& local, int* iterations = 0);
+
+/**
+ * @brief Grava o vetor de sufixos em formato binário.
+ *
+ * Formato: "SUFA" (4 bytes), tamanho do texto (uint64) e as posições iniciais dos sufixos
+ * (uint64 cada) em ordem lexicográfica, na ordem de bytes nativa.
+ *
+ * @param filename Nome do arquivo de saída.
+ * @param suffix_array Vetor de sufixos completo.
+ */
+void write_suffix_array_file(const std::string& filename, const std::vector<uint64_t>& suffix_array);
+
+} // namespace dnasort
+
+#endif // SUFFIX_ARRAY_H
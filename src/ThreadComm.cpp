@@ -0,0 +1,303 @@
+/**
+ * @file ThreadComm.cpp
+ * @brief Implementação de Comm com threads em um único processo.
+ */
+
+#include "ThreadComm.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+using namespace std;
+
+namespace dnasort {
+
+/**
+ * @brief Mensagem ponto a ponto: bytes copiados ou sequências movidas.
+ */
+struct ThreadMessage {
+    vector<char> bytes;
+    vector<string> strings;
+};
+
+/**
+ * @brief Buffers publicados por uma thread na operação coletiva corrente.
+ */
+struct ThreadSlot {
+    const void* data = 0;
+    const size_t* counts = 0;
+    vector<string>* strings = 0;
+};
+
+/**
+ * @brief Estado compartilhado pelas threads de um grupo.
+ */
+class ThreadGroup {
+public:
+    explicit ThreadGroup(int size) : size(size), slots(size) {}
+
+    /**
+     * @brief Barreira reutilizável; também ordena as escritas nos slots antes das leituras.
+     */
+    void barrier() {
+        unique_lock<mutex> lock(barrier_mutex);
+        unsigned long gen = generation;
+        if (++waiting == size) {
+            waiting = 0;
+            generation++;
+            barrier_cv.notify_all();
+        } else {
+            barrier_cv.wait(lock, [&] { return gen != generation; });
+        }
+    }
+
+    /** @brief Entrega uma mensagem na caixa (origem, destino, tag). */
+    void post(int source, int dest, int tag, ThreadMessage msg) {
+        lock_guard<mutex> lock(mail_mutex);
+        mailbox[make_tuple(source, dest, tag)].push_back(move(msg));
+        mail_cv.notify_all();
+    }
+
+    /** @brief Retira a próxima mensagem da caixa (origem, destino, tag), esperando se necessário. */
+    ThreadMessage take(int source, int dest, int tag) {
+        unique_lock<mutex> lock(mail_mutex);
+        auto key = make_tuple(source, dest, tag);
+        mail_cv.wait(lock, [&] { return !mailbox[key].empty(); });
+        ThreadMessage msg = move(mailbox[key].front());
+        mailbox[key].pop_front();
+        return msg;
+    }
+
+    const int size;
+    vector<ThreadSlot> slots;
+
+private:
+    mutex barrier_mutex;
+    condition_variable barrier_cv;
+    int waiting = 0;
+    unsigned long generation = 0;
+
+    mutex mail_mutex;
+    condition_variable mail_cv;
+    map<tuple<int, int, int>, deque<ThreadMessage>> mailbox;
+};
+
+/**
+ * @brief Combina count valores de cada slot em [first, last) com a operação op.
+ */
+template <typename T>
+static void reduce_slots(const vector<ThreadSlot>& slots, int first, int last, T* out, int count, ReduceOp op) {
+    for (int i = 0; i < count; i++) {
+        T acc = ((const T*)slots[first].data)[i];
+        for (int p = first + 1; p < last; p++) {
+            T v = ((const T*)slots[p].data)[i];
+            if (op == ReduceOp::SUM) acc += v;
+            else if (op == ReduceOp::MAX) acc = max(acc, v);
+            else acc = min(acc, v);
+        }
+        out[i] = acc;
+    }
+}
+
+static void reduce_slots(const vector<ThreadSlot>& slots, int first, int last, void* out, int count,
+                         DataType type, ReduceOp op) {
+    switch (type) {
+        case DataType::INT64:  reduce_slots(slots, first, last, (long long*)out, count, op); break;
+        case DataType::UINT64: reduce_slots(slots, first, last, (unsigned long long*)out, count, op); break;
+        default:               reduce_slots(slots, first, last, (double*)out, count, op); break;
+    }
+}
+
+ThreadComm::ThreadComm(shared_ptr<ThreadGroup> group, int rank) : group_(group), rank_(rank) {}
+
+int ThreadComm::size() const {
+    return group_->size;
+}
+
+double ThreadComm::wtime() const {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void ThreadComm::barrier() {
+    group_->barrier();
+}
+
+unique_ptr<Comm> ThreadComm::split(int color, int key) {
+    int mine[2] = {color, key};
+    vector<int> all(2 * group_->size);
+    allgather(mine, sizeof(mine), all.data());
+
+    // Membros da mesma cor em ordem de (key, rank); o primeiro cria o novo grupo
+    vector<pair<int, int>> members;
+    for (int p = 0; p < group_->size; p++) {
+        if (all[2 * p] == color) members.emplace_back(all[2 * p + 1], p);
+    }
+    std::sort(members.begin(), members.end());
+    int new_rank = 0;
+    while (members[new_rank].second != rank_) new_rank++;
+    int leader = members[0].second;
+
+    shared_ptr<ThreadGroup> sub;
+    if (rank_ == leader) sub = make_shared<ThreadGroup>(members.size());
+    publish(&sub);
+    if (rank_ != leader) sub = *(const shared_ptr<ThreadGroup>*)group_->slots[leader].data;
+    group_->barrier();
+    return unique_ptr<Comm>(new ThreadComm(sub, new_rank));
+}
+
+void ThreadComm::publish(const void* data, const size_t* counts, vector<string>* strings) {
+    ThreadSlot& slot = group_->slots[rank_];
+    slot.data = data;
+    slot.counts = counts;
+    slot.strings = strings;
+    group_->barrier();
+}
+
+void ThreadComm::send(const void* buf, size_t bytes, int dest, int tag) {
+    ThreadMessage msg;
+    msg.bytes.assign((const char*)buf, (const char*)buf + bytes);
+    group_->post(rank_, dest, tag, move(msg));
+}
+
+void ThreadComm::recv(void* buf, size_t bytes, int source, int tag) {
+    ThreadMessage msg = group_->take(source, rank_, tag);
+    if (bytes > 0) memcpy(buf, msg.bytes.data(), min(bytes, msg.bytes.size()));
+}
+
+void ThreadComm::bcast(void* buf, size_t bytes, int root) {
+    publish(buf);
+    if (rank_ != root && bytes > 0) memcpy(buf, group_->slots[root].data, bytes);
+    group_->barrier();
+}
+
+void ThreadComm::gather(const void* send, size_t bytes, void* recv, int root) {
+    publish(send);
+    if (rank_ == root && bytes > 0) {
+        for (int p = 0; p < group_->size; p++) memcpy((char*)recv + p * bytes, group_->slots[p].data, bytes);
+    }
+    group_->barrier();
+}
+
+void ThreadComm::gatherv(const void* send, size_t /* bytes */, void* recv, const size_t* recv_bytes, int root) {
+    publish(send);
+    if (rank_ == root) {
+        size_t offset = 0;
+        for (int p = 0; p < group_->size; p++) {
+            if (recv_bytes[p] > 0) memcpy((char*)recv + offset, group_->slots[p].data, recv_bytes[p]);
+            offset += recv_bytes[p];
+        }
+    }
+    group_->barrier();
+}
+
+void ThreadComm::allgather(const void* send, size_t bytes, void* recv) {
+    publish(send);
+    if (bytes > 0) {
+        for (int p = 0; p < group_->size; p++) memcpy((char*)recv + p * bytes, group_->slots[p].data, bytes);
+    }
+    group_->barrier();
+}
+
+void ThreadComm::alltoall(const void* send, size_t bytes, void* recv) {
+    publish(send);
+    if (bytes > 0) {
+        for (int p = 0; p < group_->size; p++) {
+            memcpy((char*)recv + p * bytes, (const char*)group_->slots[p].data + rank_ * bytes, bytes);
+        }
+    }
+    group_->barrier();
+}
+
+void ThreadComm::alltoallv(const void* send, const size_t* send_bytes, void* recv, const size_t* recv_bytes) {
+    publish(send, send_bytes);
+    size_t recv_offset = 0;
+    for (int p = 0; p < group_->size; p++) {
+        const ThreadSlot& slot = group_->slots[p];
+        size_t offset = 0;
+        for (int q = 0; q < rank_; q++) offset += slot.counts[q];
+        if (recv_bytes[p] > 0) memcpy((char*)recv + recv_offset, (const char*)slot.data + offset, recv_bytes[p]);
+        recv_offset += recv_bytes[p];
+    }
+    group_->barrier();
+}
+
+void ThreadComm::allreduce(const void* in, void* out, int count, DataType type, ReduceOp op) {
+    publish(in);
+    reduce_slots(group_->slots, 0, group_->size, out, count, type, op);
+    group_->barrier();
+}
+
+void ThreadComm::exscan(const void* in, void* out, int count, DataType type, ReduceOp op) {
+    publish(in);
+    if (rank_ == 0) memset(out, 0, count * 8);
+    else reduce_slots(group_->slots, 0, rank_, out, count, type, op);
+    group_->barrier();
+}
+
+void ThreadComm::send_strings(vector<string>& data, int dest, int tag) {
+    ThreadMessage msg;
+    msg.strings.swap(data);
+    group_->post(rank_, dest, tag, move(msg));
+}
+
+vector<string> ThreadComm::recv_strings(int source, int tag) {
+    return move(group_->take(source, rank_, tag).strings);
+}
+
+vector<string> ThreadComm::gather_strings(vector<string>& local, int root) {
+    publish(0, 0, &local);
+    vector<string> gathered;
+    if (rank_ == root) {
+        for (int p = 0; p < group_->size; p++) {
+            for (auto& seq : *group_->slots[p].strings) gathered.push_back(move(seq));
+        }
+    }
+    group_->barrier();
+    vector<string>().swap(local);
+    return gathered;
+}
+
+void ThreadComm::bcast_strings(vector<string>& data, int root) {
+    publish(0, 0, &data);
+    if (rank_ != root) data = *group_->slots[root].strings;
+    group_->barrier();
+}
+
+vector<string> ThreadComm::alltoallv_strings(vector<string>& send, const vector<size_t>& send_counts) {
+    publish(0, send_counts.data(), &send);
+    vector<string> received;
+    for (int p = 0; p < group_->size; p++) {
+        const ThreadSlot& slot = group_->slots[p];
+        size_t offset = 0;
+        for (int q = 0; q < rank_; q++) offset += slot.counts[q];
+        // Cada thread move apenas o seu intervalo do vetor de origem
+        for (size_t i = offset; i < offset + slot.counts[rank_]; i++) received.push_back(move((*slot.strings)[i]));
+    }
+    group_->barrier();
+    vector<string>().swap(send);
+    return received;
+}
+
+void run_threads(int n, const function<void(Comm&)>& body) {
+    shared_ptr<ThreadGroup> group = make_shared<ThreadGroup>(n);
+    vector<thread> threads;
+    for (int r = 1; r < n; r++) {
+        threads.emplace_back([&body, group, r] {
+            ThreadComm comm(group, r);
+            body(comm);
+        });
+    }
+    ThreadComm comm(group, 0);
+    body(comm);
+    for (auto& t : threads) t.join();
+}
+
+} // namespace dnasort
@@ -0,0 +1,83 @@
+/**
+ * @file ThreadComm.h
+ * @brief Implementação de Comm com threads em um único processo.
+ *
+ * Cada rank é uma thread. Nas operações coletivas cada thread publica ponteiros para os seus
+ * buffers e, após uma barreira, cada thread lê diretamente dos buffers das demais; as
+ * sequências são movidas entre os vetores das threads, sem empacotamento nem cópia de bytes.
+ *
+ * Exemplo de uso:
+ *   dnasort::run_threads(8, [&](dnasort::Comm& comm) {
+ *       std::vector<std::string> part = dnasort::sort(comm, local[comm.rank()]);
+ *   });
+ */
+
+#ifndef THREAD_COMM_H
+#define THREAD_COMM_H
+
+#include <functional>
+#include <memory>
+
+#include "Comm.h"
+
+namespace dnasort {
+
+class ThreadGroup;
+
+/**
+ * @brief Comm em que cada rank é uma thread de um mesmo ThreadGroup.
+ */
+class ThreadComm : public Comm {
+public:
+    /**
+     * @param group Estado compartilhado pelas threads do grupo.
+     * @param rank Rank desta thread no grupo.
+     */
+    ThreadComm(std::shared_ptr<ThreadGroup> group, int rank);
+
+    int rank() const override { return rank_; }
+    int size() const override;
+    double wtime() const override;
+    void barrier() override;
+    std::unique_ptr<Comm> split(int color, int key) override;
+
+    void send(const void* buf, std::size_t bytes, int dest, int tag) override;
+    void recv(void* buf, std::size_t bytes, int source, int tag) override;
+    void bcast(void* buf, std::size_t bytes, int root) override;
+    void gather(const void* send, std::size_t bytes, void* recv, int root) override;
+    void gatherv(const void* send, std::size_t bytes, void* recv, const std::size_t* recv_bytes, int root) override;
+    void allgather(const void* send, std::size_t bytes, void* recv) override;
+    void alltoall(const void* send, std::size_t bytes, void* recv) override;
+    void alltoallv(const void* send, const std::size_t* send_bytes,
+                   void* recv, const std::size_t* recv_bytes) override;
+    void allreduce(const void* in, void* out, int count, DataType type, ReduceOp op) override;
+    void exscan(const void* in, void* out, int count, DataType type, ReduceOp op) override;
+
+    void send_strings(std::vector<std::string>& data, int dest, int tag) override;
+    std::vector<std::string> recv_strings(int source, int tag) override;
+    std::vector<std::string> gather_strings(std::vector<std::string>& local, int root) override;
+    void bcast_strings(std::vector<std::string>& data, int root) override;
+    std::vector<std::string> alltoallv_strings(std::vector<std::string>& send,
+                                               const std::vector<std::size_t>& send_counts) override;
+
+private:
+    /** @brief Publica os buffers desta thread e espera as demais. */
+    void publish(const void* data, const std::size_t* counts = 0, std::vector<std::string>* strings = 0);
+
+    std::shared_ptr<ThreadGroup> group_;
+    int rank_;
+};
+
+/**
+ * @brief Executa body em n threads, cada uma com o seu ThreadComm de rank 0 a n - 1.
+ *
+ * O rank 0 executa na thread chamadora; retorna após todas as threads terminarem.
+ *
+ * @param n Número de threads (ranks).
+ * @param body Função executada por cada rank.
+ */
+void run_threads(int n, const std::function<void(Comm&)>& body);
+
+} // namespace dnasort
+
+#endif // THREAD_COMM_H